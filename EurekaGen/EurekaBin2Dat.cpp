@@ -0,0 +1,76 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * EurekaBin2Dat program: converts a binary Eureka mesh (.ebm) to a .dat file.
+ **/
+
+#include <iostream>
+
+#include "EurekaReader.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Main program: EurekaBin2Dat
+//! ----------------------------------------------------------------------------
+int main( int i_argc, char **i_argv ) {
+  std::string l_binFile, l_datFile;
+
+  //! Options come in pairs: -flag value
+  for( int l_i = 1; l_i < i_argc; l_i += 2 ) {
+    if( (l_i + 1 >= i_argc) || (i_argv[l_i][0] != '-') ) {
+      l_binFile.clear();
+      break;
+    }
+
+    switch( i_argv[l_i][1] ) {
+      case 'i':
+        l_binFile = std::string( i_argv[l_i + 1] );
+        break;
+      case 'o':
+        l_datFile = std::string( i_argv[l_i + 1] );
+        break;
+      default:
+        l_binFile.clear();
+        break;
+    }
+  }
+
+  if( l_binFile.empty() || l_datFile.empty() ) {
+    std::cerr << "Usage: " << i_argv[0] << " -i ebm_file -o dat_file\n";
+    return EXIT_FAILURE;
+  }
+
+  Eureka::BinReader l_reader;
+  std::string l_error;
+
+  if( !l_reader.open( l_binFile.c_str(), l_error ) ||
+      !l_reader.writeDat( l_datFile.c_str(), l_error ) ) {
+    std::cerr << l_error << "! Exiting..\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
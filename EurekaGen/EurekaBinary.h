@@ -0,0 +1,100 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Binary Eureka mesh format (.ebm) written by EurekaGen.
+ *
+ * Layout (all offsets in bytes from the start of the file, 8-byte aligned):
+ *   BinHeader
+ *   BinSection[m_numSections]   (section index)
+ *   section data, in index order:
+ *     node_ids     uint64_t id[m_count]
+ *     node_coords  double   xyz[m_count][3]
+ *     elems        uint64_t nodes[m_count][4]   (element IDs are 1..m_count)
+ *     one section per nodal group (kind 7) and element group (kind 8)
+ *                  uint64_t id[m_count]
+ **/
+
+#ifndef EUREKA_BINARY_H
+#define EUREKA_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Eureka {
+  struct BinHeader;
+  struct BinSection;
+
+  //! Magic, version and byte-order marker of the binary mesh
+  const char     BIN_MAGIC[8] = { 'E', 'U', 'R', 'E', 'K', 'A', 'B', '\0' };
+  const uint32_t BIN_VERSION  = 1;
+  const uint32_t BIN_ENDIAN   = 0x01020304;
+
+  //! Maximum length (including terminator) of a section name
+  const size_t   BIN_NAMELEN  = 64;
+
+  //! Section kinds (groups use the group codes of the .dat file)
+  enum BinKind : uint32_t {
+    BIN_NODE_IDS    = 1,
+    BIN_NODE_COORDS = 2,
+    BIN_ELEMS       = 3,
+    BIN_NODAL_GROUP = 7,
+    BIN_ELEM_GROUP  = 8
+  };
+}
+
+//! ----------------------------------------------------------------------------
+//! Binary mesh header
+//! ----------------------------------------------------------------------------
+struct Eureka::BinHeader {
+  char     m_magic[8];
+  uint32_t m_version;
+  uint32_t m_endian;
+  uint64_t m_numSections;
+  uint64_t m_fileSize;
+};
+
+//! ----------------------------------------------------------------------------
+//! Section index entry
+//! ----------------------------------------------------------------------------
+struct Eureka::BinSection {
+  char     m_name[BIN_NAMELEN];
+
+  //! Eureka::BinKind
+  uint32_t m_kind;
+
+  //! 8-byte values per entry (1, 3 for coordinates or 4 for elements)
+  uint32_t m_width;
+
+  uint64_t m_count;
+  uint64_t m_offset;
+};
+
+static_assert( sizeof( double ) == 8, "Binary mesh stores 8-byte reals" );
+static_assert( sizeof( Eureka::BinHeader ) == 32, "Unexpected header padding" );
+static_assert( sizeof( Eureka::BinSection ) == 88, "Unexpected index padding" );
+
+#endif
\ No newline at end of file
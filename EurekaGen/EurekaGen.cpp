@@ -30,34 +30,107 @@
 
 #include "EurekaWriter.hpp"
 
+//! ----------------------------------------------------------------------------
+//! Convert mapped msh file with writer storing indices as I and coordinates
+//! as R (returns false if node IDs exceed I)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+static bool convert( const std::string        &i_conFile,
+                     const Eureka::MappedFile &i_msh,
+                     const UID                &i_numElems,
+                     const std::string        &i_datFile,
+                     const std::string        &i_matFile ) {
+  //! Writer object
+  Eureka::Writer< I, R > l_writer( i_msh, i_numElems, i_datFile.c_str(),
+                                   i_matFile.c_str() );
+
+  //! Parse config file
+  l_writer.parseConfigFile( i_conFile.c_str() );
+
+  //! Write header
+  return l_writer.readMshWriteDat();
+}
+
 //! ----------------------------------------------------------------------------
 //! Main program: EurekaGen
 //! ----------------------------------------------------------------------------
 int main( int i_argc, char **i_argv ) {
-  if( i_argc != 7 ) {
-    std::cerr << "Usage: " << i_argv[0] << " -f conf_file -i msh_file -o dat_file\n";
+  //! Filenames (material manifest defaults to GeoGen.mat)
+  std::string l_conFile, l_mshFile, l_datFile, l_matFile = "GeoGen.mat";
+
+  //! Options come in pairs: -flag value
+  for( int l_i = 1; l_i < i_argc; l_i += 2 ) {
+    if( (l_i + 1 >= i_argc) || (i_argv[l_i][0] != '-') ) {
+      l_conFile.clear();
+      break;
+    }
+
+    switch( i_argv[l_i][1] ) {
+      case 'f':
+        l_conFile = std::string( i_argv[l_i + 1] );
+        break;
+      case 'i':
+        l_mshFile = std::string( i_argv[l_i + 1] );
+        break;
+      case 'o':
+        l_datFile = std::string( i_argv[l_i + 1] );
+        break;
+      case 'm':
+        l_matFile = std::string( i_argv[l_i + 1] );
+        break;
+      default:
+        l_conFile.clear();
+        break;
+    }
+  }
+
+  if( l_conFile.empty() || l_mshFile.empty() || l_datFile.empty() ) {
+    std::cerr << "Usage: " << i_argv[0]
+              << " -f conf_file -i msh_file -o dat_file [-m mat_file]\n";
     return EXIT_FAILURE;
-  } else if( (i_argv == nullptr)   ||
-             (i_argv[1][0] != '-') || (i_argv[1][1] != 'f') ||
-             (i_argv[3][0] != '-') || (i_argv[3][1] != 'i') ||
-             (i_argv[5][0] != '-') || (i_argv[5][1] != 'o') ) {
-    std::cerr << "Usage: " << i_argv[0] << " -f conf_file -i msh_file -o dat_file\n";
+  }
+
+  //! Map msh file, shared by the header counts and the writer
+  Eureka::MappedFile l_msh;
+  if( !l_msh.open( l_mshFile.c_str() ) ) {
+    std::cerr << "Couldn't open " << l_mshFile << "! Exiting..\n";
     return EXIT_FAILURE;
   }
 
-  //! Filenames
-  std::string l_conFile = std::string( i_argv[2] );
-  std::string l_mshFile = std::string( i_argv[4] );
-  std::string l_datFile = std::string( i_argv[6] );
+  //! Largest node ID (number of nodes for 2.2) and number of elements from
+  //! the section headers (headers that can't be read are left to the parser
+  //! to report, with 64-bit indices)
+  UID l_maxNode = 0, l_numElems = 0;
+  UID l_maxIndex = std::numeric_limits< UID >::max();
+  if( Eureka::mshCounts( l_msh, l_maxNode, l_numElems ) )
+    l_maxIndex = std::max( l_maxNode, l_numElems );
 
-  //! Writer object
-  Eureka::Writer l_writer( l_mshFile.c_str(), l_datFile.c_str() );
+  //! Dispatch to the writer for the chosen index and coordinate types
+  bool l_wideIndex, l_autoIndex, l_singleCoords;
+  Eureka::selectTypes( l_conFile.c_str(), l_maxIndex, l_wideIndex, l_autoIndex,
+                       l_singleCoords );
 
-  //! Parse config file
-  l_writer.parseConfigFile( l_conFile.c_str() );
+  if( !l_wideIndex ) {
+    bool l_fits = l_singleCoords ?
+                  convert< uint32_t, float >( l_conFile, l_msh, l_numElems, l_datFile, l_matFile ) :
+                  convert< uint32_t, double >( l_conFile, l_msh, l_numElems, l_datFile, l_matFile );
+    if( l_fits )
+      return EXIT_SUCCESS;
 
-  //! Write header
-  l_writer.readMshWriteDat();
+    //! Node IDs beyond the 32-bit range only show in parsing (2.2 headers hold
+    //! the number of nodes)
+    if( !l_autoIndex ) {
+      std::cerr << "Set index_width=64 for these node IDs! Exiting..\n";
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Retrying with 64-bit indices\n";
+  }
+
+  if( l_singleCoords )
+    convert< uint64_t, float >( l_conFile, l_msh, l_numElems, l_datFile, l_matFile );
+  else
+    convert< uint64_t, double >( l_conFile, l_msh, l_numElems, l_datFile, l_matFile );
 
   return EXIT_SUCCESS;
 }
\ No newline at end of file
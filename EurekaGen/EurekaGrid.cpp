@@ -0,0 +1,451 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Uniform grid over particle bounding boxes for point-in-particle queries,
+ * with a voxel label grid answering most queries without a containment test.
+ **/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "EurekaGrid.hpp"
+#include "EurekaWriter.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Bounding box of i_i-th particle of material (padded by i_pad)
+//! ----------------------------------------------------------------------------
+static void particleBox( const Eureka::Material &i_mat,
+                         const UID              &i_i,
+                         const real             &i_pad,
+                               real             (&o_min)[3],
+                               real             (&o_max)[3] ) {
+  geo::Vector l_A = i_mat.getCP( i_i, 0 );
+  geo::Vector l_B = (i_mat.m_morph == geo::Morph::CYLINDER) ? i_mat.getCP( i_i, 1 ) : l_A;
+  real l_rad = i_mat.m_radList[i_i] + i_pad;
+
+  o_min[0] = std::min( l_A.m_x, l_B.m_x ) - l_rad;
+  o_min[1] = std::min( l_A.m_y, l_B.m_y ) - l_rad;
+  o_min[2] = std::min( l_A.m_z, l_B.m_z ) - l_rad;
+  o_max[0] = std::max( l_A.m_x, l_B.m_x ) + l_rad;
+  o_max[1] = std::max( l_A.m_y, l_B.m_y ) + l_rad;
+  o_max[2] = std::max( l_A.m_z, l_B.m_z ) + l_rad;
+}
+
+//! ----------------------------------------------------------------------------
+//! Cell coordinate along axis (-1 below, m_dims[i_axis] above the grid)
+//! ----------------------------------------------------------------------------
+long Eureka::ParticleGrid::cellCoord( const real &i_x,
+                                      const int  &i_axis ) const {
+  real l_c = std::floor( (i_x - m_min[i_axis]) / m_cellSize );
+
+  //! Also catches NaN
+  if( !(l_c >= 0.0) )
+    return -1;
+
+  return (l_c >= m_dims[i_axis]) ? m_dims[i_axis] : (long) l_c;
+}
+
+//! ----------------------------------------------------------------------------
+//! Voxel coordinate along axis (-1 below, m_voxelDims[i_axis] above the labels)
+//! ----------------------------------------------------------------------------
+long Eureka::ParticleGrid::voxelCoord( const real &i_x,
+                                       const int  &i_axis ) const {
+  real l_v = std::floor( (i_x - m_min[i_axis]) / m_voxelSize );
+
+  //! Also catches NaN
+  if( !(l_v >= 0.0) )
+    return -1;
+
+  return (l_v >= m_voxelDims[i_axis]) ? m_voxelDims[i_axis] : (long) l_v;
+}
+
+//! ----------------------------------------------------------------------------
+//! Voxels of i_res along the longest axis of the grid
+//! ----------------------------------------------------------------------------
+void Eureka::ParticleGrid::setVoxels( const long &i_res ) {
+  real l_span = m_cellSize * std::max( { m_dims[0], m_dims[1], m_dims[2] } );
+  m_voxelSize = l_span / i_res;
+  for( int l_k = 0; l_k < 3; l_k++ )
+    m_voxelDims[l_k] = std::max( 1L, (long) std::ceil( m_cellSize * m_dims[l_k] / m_voxelSize ) );
+}
+
+//! ----------------------------------------------------------------------------
+//! Voxels of the bounding box of particle i_p widened by i_near
+//! ----------------------------------------------------------------------------
+void Eureka::ParticleGrid::voxelBox( const size_t &i_p,
+                                     const real   &i_near,
+                                     long         (&o_v0)[3],
+                                     long         (&o_v1)[3] ) const {
+  real l_A[3] = { m_ax[i_p], m_ay[i_p], m_az[i_p] };
+  real l_U[3] = { m_ux[i_p], m_uy[i_p], m_uz[i_p] };
+
+  for( int l_k = 0; l_k < 3; l_k++ ) {
+    o_v0[l_k] = std::max( 0L, voxelCoord( std::min( l_A[l_k], l_A[l_k] + l_U[l_k] ) - i_near,
+                                          l_k ) );
+    o_v1[l_k] = std::min( m_voxelDims[l_k] - 1,
+                          voxelCoord( std::max( l_A[l_k], l_A[l_k] + l_U[l_k] ) + i_near,
+                                      l_k ) );
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Number of voxel visits labelling takes (sum of the voxel boxes), counted
+//! until it exceeds i_max
+//! ----------------------------------------------------------------------------
+double Eureka::ParticleGrid::labelWork( const real   &i_pad,
+                                        const double &i_max ) const {
+  real l_half = 0.5 * std::sqrt( 3.0 ) * m_voxelSize;
+  double l_work = 0.0;
+
+  for( size_t l_p = 0; l_p < m_ax.size() && l_work <= i_max; l_p++ ) {
+    if( m_rad2[l_p] < 0.0 )
+      continue;
+
+    long l_v0[3], l_v1[3];
+    voxelBox( l_p, std::sqrt( m_rad2[l_p] ) + l_half + i_pad, l_v0, l_v1 );
+    l_work += (double) std::max( 0L, l_v1[0] - l_v0[0] + 1 ) *
+                       std::max( 0L, l_v1[1] - l_v0[1] + 1 ) *
+                       std::max( 0L, l_v1[2] - l_v0[2] + 1 );
+  }
+
+  return l_work;
+}
+
+//! ----------------------------------------------------------------------------
+//! Label voxels (as set by setVoxels) in parallel over slabs of voxel layers:
+//! matrix if no particle comes near the voxel, 1 + material if the voxel lies
+//! inside a particle of the material and no other material comes near it,
+//! else mixed. Near and inside are decided for the sphere around the voxel,
+//! widened and narrowed by i_pad, so labels never contradict the containment
+//! test
+//! ----------------------------------------------------------------------------
+void Eureka::ParticleGrid::label( const real         &i_pad,
+                                  Eureka::ThreadPool &i_pool ) {
+  size_t l_plane = m_voxelDims[0] * m_voxelDims[1];
+  m_labels.assign( l_plane * m_voxelDims[2], Eureka::VOXELMATRIX );
+
+  //! Voxels lying inside a particle
+  std::vector< unsigned char > l_inside( m_labels.size(), 0 );
+
+  //! Radius of the sphere around a voxel
+  real l_half = 0.5 * std::sqrt( 3.0 ) * m_voxelSize;
+
+  size_t l_slabs = std::min( (size_t) m_voxelDims[2], (size_t) 4 * i_pool.size() );
+  i_pool.run( l_slabs, [&]( size_t i_s, unsigned int ) {
+    long l_zBeg = i_s * m_voxelDims[2] / l_slabs;
+    long l_zEnd = (i_s + 1) * m_voxelDims[2] / l_slabs;
+
+    for( size_t l_p = 0; l_p < m_ax.size(); l_p++ ) {
+      //! Degenerate cylinders contain nothing
+      if( m_rad2[l_p] < 0.0 )
+        continue;
+
+      real l_A[3]  = { m_ax[l_p], m_ay[l_p], m_az[l_p] };
+      real l_U[3]  = { m_ux[l_p], m_uy[l_p], m_uz[l_p] };
+      real l_rad   = std::sqrt( m_rad2[l_p] );
+      real l_len   = std::sqrt( m_len2[l_p] );
+      real l_near  = l_rad + l_half + i_pad;
+      real l_inner = l_rad - l_half - i_pad;
+      unsigned char l_label = (m_mat[l_p] + 1 < Eureka::VOXELMIXED) ?
+                              (unsigned char) (m_mat[l_p] + 1) : Eureka::VOXELMIXED;
+
+      //! Voxels of the (widened) bounding box within the slab
+      long l_v0[3], l_v1[3];
+      voxelBox( l_p, l_near, l_v0, l_v1 );
+      l_v0[2] = std::max( l_v0[2], l_zBeg );
+      l_v1[2] = std::min( l_v1[2], l_zEnd - 1 );
+
+      for( long l_z = l_v0[2]; l_z <= l_v1[2]; l_z++ )
+        for( long l_y = l_v0[1]; l_y <= l_v1[1]; l_y++ )
+          for( long l_x = l_v0[0]; l_x <= l_v1[0]; l_x++ ) {
+            //! Center relative to A, its position along and distance from the
+            //! axis (AB.AP as in find) and distance from segment AB
+            real l_d[3] = { m_min[0] + (l_x + 0.5) * m_voxelSize - l_A[0],
+                            m_min[1] + (l_y + 0.5) * m_voxelSize - l_A[1],
+                            m_min[2] + (l_z + 0.5) * m_voxelSize - l_A[2] };
+            real l_c = l_d[0] * l_U[0] + l_d[1] * l_U[1] + l_d[2] * l_U[2];
+            real l_t = l_c * m_invLen2[l_p];
+            real l_s = std::min( std::max( l_t, 0.0 ), 1.0 );
+            real l_axis2 = 0.0, l_seg2 = 0.0;
+            for( int l_k = 0; l_k < 3; l_k++ ) {
+              l_axis2 += (l_d[l_k] - l_t * l_U[l_k]) * (l_d[l_k] - l_t * l_U[l_k]);
+              l_seg2  += (l_d[l_k] - l_s * l_U[l_k]) * (l_d[l_k] - l_s * l_U[l_k]);
+            }
+
+            if( l_seg2 > l_near * l_near )
+              continue;
+
+            size_t l_v = l_z * l_plane + l_y * m_voxelDims[0] + l_x;
+            unsigned char &l_old = m_labels[l_v];
+            l_old = (l_old == Eureka::VOXELMATRIX || l_old == l_label) ? l_label :
+                                                                         Eureka::VOXELMIXED;
+
+            if( l_inner > 0.0 && l_axis2 <= l_inner * l_inner &&
+                l_c >= (l_half + i_pad) * l_len && l_c <= m_len2[l_p] - (l_half + i_pad) * l_len )
+              l_inside[l_v] = 1;
+          }
+    }
+
+    //! Voxels near particles but inside none are mixed
+    for( size_t l_v = l_zBeg * l_plane; l_v < l_zEnd * l_plane; l_v++ )
+      if( m_labels[l_v] != Eureka::VOXELMATRIX && !l_inside[l_v] )
+        m_labels[l_v] = Eureka::VOXELMIXED;
+  } );
+}
+
+//! ----------------------------------------------------------------------------
+//! Fraction of voxels needing containment tests (0 without labels)
+//! ----------------------------------------------------------------------------
+real Eureka::ParticleGrid::mixedFraction() const {
+  if( m_labels.empty() )
+    return 0.0;
+
+  return (real) std::count( m_labels.begin(), m_labels.end(), Eureka::VOXELMIXED ) /
+         m_labels.size();
+}
+
+//! ----------------------------------------------------------------------------
+//! Build grid over the particles of all materials, and voxel labels (i_voxelRes
+//! along the longest axis, none if 0; LABELAUTO: finest resolution up to
+//! LABELRES whose labelling costs at most LABELWORK voxel visits per query
+//! of the i_queries expected, none if even LABELMINRES costs more)
+//! ----------------------------------------------------------------------------
+void Eureka::ParticleGrid::build( const std::vector< Eureka::Material * > &i_mats,
+                                  const long                              &i_voxelRes,
+                                  const UID                               &i_queries,
+                                  Eureka::ThreadPool                      &i_pool ) {
+  m_cellStart.clear();
+  m_items.clear();
+  m_labels.clear();
+
+  //! Invariants and bounds of all particles
+  UID  l_num = 0;
+  real l_lo[3], l_hi[3], l_min[3], l_max[3];
+  for( int l_k = 0; l_k < 3; l_k++ ) {
+    l_lo[l_k] =  std::numeric_limits< real >::max();
+    l_hi[l_k] = -std::numeric_limits< real >::max();
+  }
+
+  for( size_t l_m = 0; l_m < i_mats.size(); l_m++ )
+    l_num += i_mats[l_m]->m_numParticles;
+
+  m_ax.resize( l_num );  m_ay.resize( l_num );  m_az.resize( l_num );
+  m_ux.resize( l_num );  m_uy.resize( l_num );  m_uz.resize( l_num );
+  m_len2.resize( l_num ); m_invLen2.resize( l_num );
+  m_rad2.resize( l_num ); m_mat.resize( l_num );
+
+  UID l_p = 0;
+  for( size_t l_m = 0; l_m < i_mats.size(); l_m++ )
+    for( UID l_i = 0; l_i < i_mats[l_m]->m_numParticles; l_i++, l_p++ ) {
+      const Eureka::Material &l_mat = *i_mats[l_m];
+      geo::Vector l_A = l_mat.getCP( l_i, 0 );
+      real l_rad = l_mat.m_radList[l_i];
+
+      m_ax[l_p]   = l_A.m_x;
+      m_ay[l_p]   = l_A.m_y;
+      m_az[l_p]   = l_A.m_z;
+      m_ux[l_p]   = m_uy[l_p] = m_uz[l_p] = 0.0;
+      m_len2[l_p] = m_invLen2[l_p] = 0.0;
+      m_rad2[l_p] = l_rad * l_rad;
+      m_mat[l_p]  = l_m;
+
+      if( l_mat.m_morph == geo::Morph::CYLINDER ) {
+        geo::Vector l_AB( l_A, l_mat.getCP( l_i, 1 ) );
+        m_ux[l_p]   = l_AB.m_x;
+        m_uy[l_p]   = l_AB.m_y;
+        m_uz[l_p]   = l_AB.m_z;
+        m_len2[l_p] = l_AB.m_x * l_AB.m_x + l_AB.m_y * l_AB.m_y + l_AB.m_z * l_AB.m_z;
+
+        //! Degenerate cylinders contain nothing
+        if( m_len2[l_p] > 0.0 )
+          m_invLen2[l_p] = 1.0 / m_len2[l_p];
+        else
+          m_rad2[l_p] = -1.0;
+      }
+
+      particleBox( l_mat, l_i, 0.0, l_min, l_max );
+      for( int l_k = 0; l_k < 3; l_k++ ) {
+        l_lo[l_k] = std::min( l_lo[l_k], l_min[l_k] );
+        l_hi[l_k] = std::max( l_hi[l_k], l_max[l_k] );
+      }
+    }
+
+  if( !l_num )
+    return;
+
+  //! Pad boxes so round-off in the containment tests never misses a cell
+  real l_ext[3], l_maxExt = 0.0, l_maxAbs = 0.0;
+  for( int l_k = 0; l_k < 3; l_k++ ) {
+    l_maxAbs = std::max( l_maxAbs, std::max( std::fabs( l_lo[l_k] ), std::fabs( l_hi[l_k] ) ) );
+    l_maxExt = std::max( l_maxExt, l_hi[l_k] - l_lo[l_k] );
+  }
+  real l_pad = 1.0e-9 * (l_maxAbs + l_maxExt);
+
+  for( int l_k = 0; l_k < 3; l_k++ ) {
+    m_min[l_k] = l_lo[l_k] - l_pad;
+    l_ext[l_k] = l_hi[l_k] - l_lo[l_k] + 2.0 * l_pad;
+  }
+
+  //! About two cells per particle, at most 1024 cells along an axis
+  m_cellSize = std::max( std::cbrt( l_ext[0] * l_ext[1] * l_ext[2] / (2.0 * l_num) ),
+                         (l_maxExt + 2.0 * l_pad) / 1024.0 );
+  if( !(m_cellSize > 0.0) )
+    m_cellSize = 1.0;
+
+  for( int l_k = 0; l_k < 3; l_k++ )
+    m_dims[l_k] = std::max( 1L, (long) std::ceil( l_ext[l_k] / m_cellSize ) );
+
+  //! Count particles per cell, then fill cells (two passes)
+  m_cellStart.assign( m_dims[0] * m_dims[1] * m_dims[2] + 1, 0 );
+  std::vector< UID > l_fill;
+
+  for( int l_pass = 0; l_pass < 2; l_pass++ ) {
+    l_p = 0;
+    for( size_t l_m = 0; l_m < i_mats.size(); l_m++ )
+      for( UID l_i = 0; l_i < i_mats[l_m]->m_numParticles; l_i++, l_p++ ) {
+        particleBox( *i_mats[l_m], l_i, l_pad, l_min, l_max );
+
+        long l_c0[3], l_c1[3];
+        for( int l_k = 0; l_k < 3; l_k++ ) {
+          l_c0[l_k] = std::max( 0L, cellCoord( l_min[l_k], l_k ) );
+          l_c1[l_k] = std::min( m_dims[l_k] - 1, cellCoord( l_max[l_k], l_k ) );
+        }
+
+        for( long l_z = l_c0[2]; l_z <= l_c1[2]; l_z++ )
+          for( long l_y = l_c0[1]; l_y <= l_c1[1]; l_y++ )
+            for( long l_x = l_c0[0]; l_x <= l_c1[0]; l_x++ ) {
+              size_t l_cell = (l_z * m_dims[1] + l_y) * m_dims[0] + l_x;
+              if( l_pass == 0 )
+                m_cellStart[l_cell + 1]++;
+              else
+                m_items[l_fill[l_cell]++] = l_p;
+            }
+      }
+
+    if( l_pass == 0 ) {
+      for( size_t l_c = 1; l_c < m_cellStart.size(); l_c++ )
+        m_cellStart[l_c] += m_cellStart[l_c - 1];
+
+      m_items.resize( m_cellStart.back() );
+      l_fill.assign( m_cellStart.begin(), m_cellStart.end() - 1 );
+    }
+  }
+
+  if( i_voxelRes > 0 ) {
+    setVoxels( std::min( i_voxelRes, Eureka::LABELMAXRES ) );
+    label( l_pad, i_pool );
+  }
+  else if( i_voxelRes == Eureka::LABELAUTO )
+    for( long l_res = Eureka::LABELRES; l_res >= Eureka::LABELMINRES; l_res /= 2 ) {
+      double l_max = (double) Eureka::LABELWORK * i_queries;
+
+      setVoxels( l_res );
+      if( labelWork( l_pad, l_max ) <= l_max ) {
+        label( l_pad, i_pool );
+        break;
+      }
+    }
+}
+
+//! ----------------------------------------------------------------------------
+//! Material containing point (-1: none), testing only particles of its cell
+//! ----------------------------------------------------------------------------
+int Eureka::ParticleGrid::find( const geo::Vector &i_P ) const {
+  if( m_cellStart.empty() )
+    return -1;
+
+  //! Voxel label settles the point unless mixed
+  if( !m_labels.empty() ) {
+    long l_vx = voxelCoord( i_P.m_x, 0 );
+    long l_vy = voxelCoord( i_P.m_y, 1 );
+    long l_vz = voxelCoord( i_P.m_z, 2 );
+    if( l_vx >= 0 && l_vy >= 0 && l_vz >= 0 &&
+        l_vx < m_voxelDims[0] && l_vy < m_voxelDims[1] && l_vz < m_voxelDims[2] ) {
+      unsigned char l_label = m_labels[(l_vz * m_voxelDims[1] + l_vy) * m_voxelDims[0] + l_vx];
+      if( l_label != Eureka::VOXELMIXED )
+        return (int) l_label - 1;
+    }
+  }
+
+  long l_x = cellCoord( i_P.m_x, 0 );
+  long l_y = cellCoord( i_P.m_y, 1 );
+  long l_z = cellCoord( i_P.m_z, 2 );
+  if( l_x < 0 || l_y < 0 || l_z < 0 ||
+      l_x >= m_dims[0] || l_y >= m_dims[1] || l_z >= m_dims[2] )
+    return -1;
+
+  size_t l_cell = (l_z * m_dims[1] + l_y) * m_dims[0] + l_x;
+  const unsigned int *l_items = m_items.data() + m_cellStart[l_cell];
+  UID l_num = m_cellStart[l_cell + 1] - m_cellStart[l_cell];
+
+  for( UID l_b = 0; l_b < l_num; l_b += Eureka::GRIDBATCH ) {
+    real l_ax[GRIDBATCH], l_ay[GRIDBATCH], l_az[GRIDBATCH];
+    real l_ux[GRIDBATCH], l_uy[GRIDBATCH], l_uz[GRIDBATCH];
+    real l_len2[GRIDBATCH], l_invLen2[GRIDBATCH], l_rad2[GRIDBATCH];
+    real l_margin[GRIDBATCH];
+
+    //! Gather batch (scalar loads; unused lanes hold a particle containing
+    //! nothing)
+    for( int l_k = 0; l_k < Eureka::GRIDBATCH; l_k++ ) {
+      UID l_p = (l_b + l_k < l_num) ? l_items[l_b + l_k] : l_items[l_b];
+
+      l_ax[l_k]   = m_ax[l_p];  l_ay[l_k] = m_ay[l_p];  l_az[l_k] = m_az[l_p];
+      l_ux[l_k]   = m_ux[l_p];  l_uy[l_k] = m_uy[l_p];  l_uz[l_k] = m_uz[l_p];
+      l_len2[l_k] = m_len2[l_p];  l_invLen2[l_k] = m_invLen2[l_p];
+      l_rad2[l_k] = (l_b + l_k < l_num) ? m_rad2[l_p] : -1.0;
+    }
+
+    //! P lies inside if AB.AP lies within [0, |AB|^2] (between the end caps)
+    //! and its squared distance from the axis is at most the squared radius,
+    //! i.e. if the smallest of the three margins is not negative. Margins keep
+    //! every lane in doubles (SSE2 has no blend to turn comparisons into
+    //! integers), so the loop vectorizes
+#pragma omp simd
+    for( int l_k = 0; l_k < Eureka::GRIDBATCH; l_k++ ) {
+      real l_dx = i_P.m_x - l_ax[l_k];
+      real l_dy = i_P.m_y - l_ay[l_k];
+      real l_dz = i_P.m_z - l_az[l_k];
+      real l_c  = l_dx * l_ux[l_k] + l_dy * l_uy[l_k] + l_dz * l_uz[l_k];
+      real l_t  = l_c * l_invLen2[l_k];
+
+      l_dx -= l_t * l_ux[l_k];
+      l_dy -= l_t * l_uy[l_k];
+      l_dz -= l_t * l_uz[l_k];
+
+      real l_radial = l_rad2[l_k] - (l_dx * l_dx + l_dy * l_dy + l_dz * l_dz);
+      l_margin[l_k] = std::min( std::min( l_c, l_len2[l_k] - l_c ), l_radial );
+    }
+
+    //! NaN margins (NaN points) compare false
+    for( int l_k = 0; l_k < Eureka::GRIDBATCH; l_k++ )
+      if( l_margin[l_k] >= 0.0 )
+        return m_mat[l_items[l_b + l_k]];
+  }
+
+  return -1;
+}
\ No newline at end of file
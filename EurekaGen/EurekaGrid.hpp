@@ -0,0 +1,134 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Uniform grid over particle bounding boxes for point-in-particle queries,
+ * with a voxel label grid answering most queries without a containment test.
+ **/
+
+#ifndef EUREKA_GRID_HPP
+#define EUREKA_GRID_HPP
+
+#include <vector>
+
+#include "EurekaConstants.h"
+#include "EurekaThreads.hpp"
+#include "../GeoGen/Geo.hpp"
+
+namespace Eureka {
+  //! Particles tested at once by a grid query
+  const int GRIDBATCH = 4;
+
+  //! Voxel labels: auto resolution, finest and coarsest resolution (voxels
+  //! along the longest axis) it tries, voxel visits it allows per query, and
+  //! finest resolution allowed at all (about 1 GiB of labels)
+  const long LABELAUTO   = -1;
+  const long LABELRES    = 256;
+  const long LABELMINRES = 32;
+  const long LABELWORK   = 1;
+  const long LABELMAXRES = 1024;
+
+  //! Voxel labels (others are 1 + material)
+  const unsigned char VOXELMATRIX = 0;
+  const unsigned char VOXELMIXED  = 255;
+
+  struct Material;
+
+  class ParticleGrid;
+}
+
+//! ----------------------------------------------------------------------------
+//! Uniform grid whose cells list the particles overlapping them (in material,
+//! then particle order, so queries find the same particle as a full search)
+//! ----------------------------------------------------------------------------
+class Eureka::ParticleGrid {
+private:
+  //! Particle invariants (structure of arrays, in material then particle
+  //! order): axis start A or sphere center, axis AB (zero for spheres),
+  //! squared axis length and its inverse, squared radius and material
+  std::vector< real > m_ax, m_ay, m_az;
+  std::vector< real > m_ux, m_uy, m_uz;
+  std::vector< real > m_len2, m_invLen2, m_rad2;
+  std::vector< unsigned int > m_mat;
+
+  //! Grid origin, cell size and number of cells per axis
+  real m_min[3], m_cellSize;
+  long m_dims[3];
+
+  //! Cell c lists particles m_items[m_cellStart[c]] .. m_items[m_cellStart[c + 1] - 1]
+  std::vector< UID > m_cellStart;
+  std::vector< unsigned int > m_items;
+
+  //! Voxel size, number of voxels per axis (from the grid origin) and label
+  //! of every voxel (empty: no labels)
+  real m_voxelSize;
+  long m_voxelDims[3];
+  std::vector< unsigned char > m_labels;
+
+  long cellCoord( const real &i_x,
+                  const int  &i_axis ) const;
+
+  long voxelCoord( const real &i_x,
+                   const int  &i_axis ) const;
+
+  void setVoxels( const long &i_res );
+
+  void voxelBox( const size_t &i_p,
+                 const real   &i_near,
+                 long         (&o_v0)[3],
+                 long         (&o_v1)[3] ) const;
+
+  double labelWork( const real   &i_pad,
+                    const double &i_max ) const;
+
+  void label( const real         &i_pad,
+              Eureka::ThreadPool &i_pool );
+
+public:
+  ParticleGrid() : m_cellSize(1.0), m_voxelSize(1.0) {
+    for( int l_k = 0; l_k < 3; l_k++ ) {
+      m_min[l_k]       = 0.0;
+      m_dims[l_k]      = 0;
+      m_voxelDims[l_k] = 0;
+    }
+  }
+
+  void build( const std::vector< Eureka::Material * > &i_mats,
+              const long                              &i_voxelRes,
+              const UID                               &i_queries,
+              Eureka::ThreadPool                      &i_pool );
+
+  //! Whether voxels are labelled, their number per axis and the fraction
+  //! needing containment tests (0 without labels)
+  bool labelled() const { return !m_labels.empty(); }
+  const long *voxelDims() const { return m_voxelDims; }
+  real mixedFraction() const;
+
+  //! Material containing point (-1: none)
+  int find( const geo::Vector &i_P ) const;
+};
+
+#endif
\ No newline at end of file
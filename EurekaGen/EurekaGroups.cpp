@@ -0,0 +1,196 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Nodal group definitions: boolean expressions over node predicates.
+ **/
+
+#include <cctype>
+#include <cstring>
+
+#include "EurekaGroups.hpp"
+
+//! Predicate names of the expressions and their bits
+static const struct {
+  const char *m_name;
+  uint16_t    m_bit;
+} s_preds[] = {
+  { "xmin",      Eureka::Face::LEFT      },
+  { "xmax",      Eureka::Face::RIGHT     },
+  { "ymin",      Eureka::Face::FRONT     },
+  { "ymax",      Eureka::Face::BACK      },
+  { "zmin",      Eureka::Face::BOTTOM    },
+  { "zmax",      Eureka::Face::TOP       },
+  { "interface", Eureka::Face::INTERFACE },
+  { "piston",    Eureka::PISTONNODE      },
+  { "matrix",    Eureka::MATRIXNODE      } };
+
+//! Default groups, in .dat order
+static const char *s_defaults[] = {
+  "top_nodes:        zmax",
+  "bottom_nodes:     zmin",
+  "left_nodes:       xmin",
+  "right_nodes:      xmax",
+  "front_nodes:      ymin",
+  "back_nodes:       ymax",
+  "corner_nodes:     (xmin | xmax) & (ymin | ymax) & zmin",
+  "top_corner_nodes: (xmin | xmax) & (ymin | ymax) & zmax",
+  "zleft_nodes:      xmin & (ymin | ymax)",
+  "zright_nodes:     xmax & (ymin | ymax)",
+  "yleft_nodes:      xmin & zmin",
+  "yright_nodes:     xmax & zmin",
+  "xfront_nodes:     ymin & zmin",
+  "xback_nodes:      ymax & zmin",
+  "matrix_nodes:     matrix & !piston",
+  "piston_nodes:     piston" };
+
+//! ----------------------------------------------------------------------------
+//! Skip blanks
+//! ----------------------------------------------------------------------------
+static void skipBlanks( const char *&io_pos ) {
+  while( *io_pos == ' ' || *io_pos == '\t' || *io_pos == '\r' )
+    io_pos++;
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse disjunction: term { '|' term }
+//! ----------------------------------------------------------------------------
+bool Eureka::NodeGroups::parseOr( const char                       *&io_pos,
+                                  std::bitset< Eureka::NODEMASKS >  &o_table ) const {
+  if( !parseAnd( io_pos, o_table ) )
+    return false;
+
+  while( *io_pos == '|' ) {
+    std::bitset< Eureka::NODEMASKS > l_rhs;
+    if( !parseAnd( ++io_pos, l_rhs ) )
+      return false;
+
+    o_table |= l_rhs;
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse conjunction: factor { '&' factor }
+//! ----------------------------------------------------------------------------
+bool Eureka::NodeGroups::parseAnd( const char                       *&io_pos,
+                                   std::bitset< Eureka::NODEMASKS >  &o_table ) const {
+  if( !parseNot( io_pos, o_table ) )
+    return false;
+
+  while( *io_pos == '&' ) {
+    std::bitset< Eureka::NODEMASKS > l_rhs;
+    if( !parseNot( ++io_pos, l_rhs ) )
+      return false;
+
+    o_table &= l_rhs;
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse factor: '!' factor, '(' disjunction ')' or predicate name (leaves
+//! io_pos past trailing blanks)
+//! ----------------------------------------------------------------------------
+bool Eureka::NodeGroups::parseNot( const char                       *&io_pos,
+                                   std::bitset< Eureka::NODEMASKS >  &o_table ) const {
+  skipBlanks( io_pos );
+
+  if( *io_pos == '!' ) {
+    if( !parseNot( ++io_pos, o_table ) )
+      return false;
+
+    o_table.flip();
+    return true;
+  }
+
+  if( *io_pos == '(' ) {
+    if( !parseOr( ++io_pos, o_table ) || *io_pos != ')' )
+      return false;
+
+    skipBlanks( ++io_pos );
+    return true;
+  }
+
+  //! Predicate: true for every mask with its bit set
+  for( size_t l_p = 0; l_p < sizeof( s_preds ) / sizeof( s_preds[0] ); l_p++ ) {
+    size_t l_len = strlen( s_preds[l_p].m_name );
+    if( strncmp( io_pos, s_preds[l_p].m_name, l_len ) ||
+        isalnum( (unsigned char) io_pos[l_len] ) || io_pos[l_len] == '_' )
+      continue;
+
+    o_table.reset();
+    for( size_t l_m = 0; l_m < Eureka::NODEMASKS; l_m++ )
+      if( l_m & s_preds[l_p].m_bit )
+        o_table.set( l_m );
+
+    io_pos += l_len;
+    skipBlanks( io_pos );
+    return true;
+  }
+
+  return false;
+}
+
+//! ----------------------------------------------------------------------------
+//! Add group defined as "name: expression" (returns false if malformed)
+//! ----------------------------------------------------------------------------
+bool Eureka::NodeGroups::add( const std::string &i_def ) {
+  size_t l_colon = i_def.find( ':' );
+  if( l_colon == std::string::npos )
+    return false;
+
+  //! Name without surrounding blanks (and none inside)
+  size_t l_beg = i_def.find_first_not_of( " \t" );
+  size_t l_end = i_def.find_last_not_of( " \t", l_colon - 1 );
+  if( l_beg >= l_colon || l_end == std::string::npos || l_end < l_beg )
+    return false;
+
+  std::string l_name = i_def.substr( l_beg, l_end - l_beg + 1 );
+  if( l_name.find_first_of( " \t" ) != std::string::npos )
+    return false;
+
+  //! Expression must take up the rest of the definition
+  std::bitset< Eureka::NODEMASKS > l_table;
+  const char *l_pos = i_def.c_str() + l_colon + 1;
+  if( !parseOr( l_pos, l_table ) || *l_pos != '\0' )
+    return false;
+
+  m_names.push_back( l_name );
+  m_tables.push_back( l_table );
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Add the default groups (box faces, edges, corners, matrix and piston)
+//! ----------------------------------------------------------------------------
+void Eureka::NodeGroups::addDefaults() {
+  for( size_t l_d = 0; l_d < sizeof( s_defaults ) / sizeof( s_defaults[0] ); l_d++ )
+    add( s_defaults[l_d] );
+}
\ No newline at end of file
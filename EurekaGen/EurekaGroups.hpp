@@ -0,0 +1,94 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Nodal group definitions: boolean expressions over node predicates.
+ **/
+
+#ifndef EUREKA_GROUPS_HPP
+#define EUREKA_GROUPS_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Eureka {
+  //! Box faces (bitmask) a boundary node lies on
+  enum Face : unsigned char {
+    TOP       = 1 << 0,
+    BOTTOM    = 1 << 1,
+    LEFT      = 1 << 2,
+    RIGHT     = 1 << 3,
+    FRONT     = 1 << 4,
+    BACK      = 1 << 5,
+    INTERFACE = 1 << 6
+  };
+
+  //! Node predicates besides the box faces (bits of the same mask)
+  const uint16_t PISTONNODE = 1 << 7;
+  const uint16_t MATRIXNODE = 1 << 8;
+
+  //! Number of predicate masks
+  const size_t NODEMASKS = 1 << 9;
+
+  class NodeGroups;
+}
+
+//! ----------------------------------------------------------------------------
+//! Nodal groups, each a name and the truth table of its expression over the
+//! predicate masks
+//! ----------------------------------------------------------------------------
+class Eureka::NodeGroups {
+private:
+  std::vector< std::string > m_names;
+  std::vector< std::bitset< Eureka::NODEMASKS > > m_tables;
+
+  bool parseOr( const char                       *&io_pos,
+                std::bitset< Eureka::NODEMASKS >  &o_table ) const;
+
+  bool parseAnd( const char                       *&io_pos,
+                 std::bitset< Eureka::NODEMASKS >  &o_table ) const;
+
+  bool parseNot( const char                       *&io_pos,
+                 std::bitset< Eureka::NODEMASKS >  &o_table ) const;
+
+public:
+  //! Add group defined as "name: expression" (returns false if malformed)
+  bool add( const std::string &i_def );
+
+  //! Add the default groups (box faces, edges, corners, matrix and piston)
+  void addDefaults();
+
+  size_t size() const { return m_names.size(); }
+  const std::string &name( const size_t &i_g ) const { return m_names[i_g]; }
+
+  //! Whether group holds nodes with predicate mask i_mask
+  bool contains( const size_t   &i_g,
+                 const uint16_t &i_mask ) const { return m_tables[i_g][i_mask]; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Memory-mapped file functions for EurekaGen.
+ **/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "EurekaMmap.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Map file into memory (returns false on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::MappedFile::open( const char *i_filename ) {
+  close();
+
+  int l_fd = ::open( i_filename, O_RDONLY );
+  if( l_fd < 0 )
+    return false;
+
+  struct stat l_stat;
+  if( fstat( l_fd, &l_stat ) != 0 ) {
+    ::close( l_fd );
+    return false;
+  }
+
+  m_size = l_stat.st_size;
+
+  //! Empty files cannot be mapped but are valid
+  if( m_size == 0 ) {
+    ::close( l_fd );
+    m_data = "";
+    return true;
+  }
+
+  void *l_addr = mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, l_fd, 0 );
+  ::close( l_fd );
+
+  if( l_addr == MAP_FAILED ) {
+    m_size = 0;
+    return false;
+  }
+
+  //! We read front to back
+  madvise( l_addr, m_size, MADV_SEQUENTIAL );
+
+  m_data = static_cast< const char * >(l_addr);
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Unmap file
+//! ----------------------------------------------------------------------------
+void Eureka::MappedFile::close() {
+  if( m_data != nullptr && m_size > 0 )
+    munmap( const_cast< char * >(m_data), m_size );
+
+  m_data = nullptr;
+  m_size = 0;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Read-only memory-mapped file.
+ **/
+
+#ifndef EUREKA_MMAP_HPP
+#define EUREKA_MMAP_HPP
+
+#include <cstddef>
+
+namespace Eureka {
+  struct MappedFile;
+}
+
+//! ----------------------------------------------------------------------------
+//! Memory-mapped (read-only) file data-structure
+//! ----------------------------------------------------------------------------
+struct Eureka::MappedFile {
+  const char *m_data;
+  size_t      m_size;
+
+  MappedFile() : m_data(nullptr), m_size(0) {}
+  ~MappedFile() { close(); }
+
+  //! Non-copyable as it owns the mapping
+  MappedFile( const MappedFile & ) = delete;
+  MappedFile & operator = ( const MappedFile & ) = delete;
+
+  bool open( const char *i_filename );
+  void close();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,877 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Gmsh .msh (2.2 and 4.1, ASCII and binary) reader functions for EurekaGen.
+ **/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "EurekaWriter.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Binary value at io_pos (in native byte order, unaligned), moves io_pos past it
+//! ----------------------------------------------------------------------------
+template< typename T >
+static T readBin( const char *&io_pos ) {
+  T l_val;
+  memcpy( &l_val, io_pos, sizeof( T ) );
+  io_pos += sizeof( T );
+
+  return l_val;
+}
+
+//! ----------------------------------------------------------------------------
+//! Report malformed part of the msh file and exit
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::mshError( const char *i_what,
+                                   const char *i_pos ) const {
+  std::cerr << "Malformed " << i_what;
+
+  //! Line numbers are meaningless in binary files
+  if( Eureka::isBinary( m_mshFormat ) )
+    std::cerr << " at byte " << i_pos - m_msh.m_data;
+  else
+    std::cerr << " on line " << std::count( m_msh.m_data, i_pos, '\n' ) + 1;
+
+  std::cerr << "! Exiting..\n";
+  exit( EXIT_FAILURE );
+}
+
+//! ----------------------------------------------------------------------------
+//! Next line of the mapped msh file (returns false at end of file)
+//! ----------------------------------------------------------------------------
+bool Eureka::WriterBase::nextLine( const char *&o_beg,
+                                   const char *&o_end ) {
+  const char *l_end = m_msh.m_data + m_msh.m_size;
+  if( m_mshPos >= l_end )
+    return false;
+
+  o_beg    = m_mshPos;
+  o_end    = Eureka::findEol( m_mshPos, l_end );
+  m_mshPos = (o_end < l_end) ? o_end + 1 : l_end;
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Skip to line starting with i_name, reading header sections on the way
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::findSection( const char *i_name ) {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  const char *l_beg, *l_end;
+
+  while( nextLine( l_beg, l_end ) ) {
+    if( Eureka::startsWith( l_beg, l_end, i_name ) )
+      return;
+
+    if( !Eureka::startsWith( l_beg, l_end, "$" ) ||
+        Eureka::startsWith( l_beg, l_end, "$End" ) )
+      continue;
+
+    if( Eureka::startsWith( l_beg, l_end, "$MeshFormat" ) )
+      readMeshFormat();
+    else if( Eureka::startsWith( l_beg, l_end, "$PhysicalNames" ) )
+      readPhysicalNames();
+    else if( Eureka::startsWith( l_beg, l_end, "$Entities" ) )
+      readEntities();
+
+    //! Skip any other section (may hold binary data) up to its end tag
+    else
+      m_mshPos = Eureka::findLine( m_mshPos, l_fileEnd, "$End" );
+  }
+
+  std::cerr << "No " << i_name << " section in msh file! Exiting..\n";
+  exit( EXIT_FAILURE );
+}
+
+//! ----------------------------------------------------------------------------
+//! Read in version, file type (ASCII/binary) and byte order of msh file
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::readMeshFormat() {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  const char *l_line    = m_mshPos;
+  const char *l_beg, *l_end;
+  Eureka::Field l_fields[Eureka::MAXFIELDS];
+
+  //! Format: version file-type data-size
+  int l_fileType, l_dataSize;
+  if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 3 ||
+      !toNum( l_fields[1], l_fileType ) || !toNum( l_fields[2], l_dataSize ) ||
+      l_fileType < 0 || l_fileType > 1 )
+    mshError( "$MeshFormat", l_line );
+
+  bool l_binary = (l_fileType == 1);
+  if( l_fields[0] == "4.1" )
+    m_mshFormat = l_binary ? Eureka::MshFormat::V41_BINARY : Eureka::MshFormat::V41_ASCII;
+  else if( l_fields[0] == "2" ||
+           Eureka::startsWith( l_fields[0].m_beg, l_fields[0].m_end, "2." ) )
+    m_mshFormat = l_binary ? Eureka::MshFormat::V22_BINARY : Eureka::MshFormat::V22_ASCII;
+  else {
+    std::cerr << "Unsupported msh version ("
+              << std::string( l_fields[0].m_beg, l_fields[0].m_end ) << ")! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  //! Reals (and 4.1 sizes) must be 8 bytes
+  if( l_dataSize != sizeof( real ) ) {
+    std::cerr << "Unsupported msh data size (" << l_dataSize << ")! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  //! Binary files hold an integer 1 to detect the byte order
+  if( l_binary ) {
+    if( (size_t) (l_fileEnd - m_mshPos) < sizeof( int ) )
+      mshError( "$MeshFormat", m_mshPos );
+
+    int l_one = readBin< int >( m_mshPos );
+    if( l_one == 0x01000000 ) {
+      std::cerr << "Msh file was written with different byte order! Exiting..\n";
+      exit( EXIT_FAILURE );
+    }
+
+    if( l_one != 1 )
+      mshError( "$MeshFormat", m_mshPos - sizeof( int ) );
+  }
+
+  //! Skip $EndMeshFormat
+  m_mshPos = Eureka::findLine( m_mshPos, l_fileEnd, "$EndMeshFormat" );
+  nextLine( l_beg, l_end );
+}
+
+//! ----------------------------------------------------------------------------
+//! Read in physical names and map volume tags to element groups
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::readPhysicalNames() {
+  const char *l_beg, *l_end;
+  Eureka::Field l_fields[Eureka::MAXFIELDS];
+
+  //! Get number of physical names
+  UID l_numNames = 0;
+  const char *l_line = m_mshPos;
+  if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 1 ||
+      !toNum( l_fields[0], l_numNames ) )
+    mshError( "$PhysicalNames", l_line );
+
+  for( UID l_i = 0; l_i < l_numNames; l_i++ ) {
+    if( !nextLine( l_beg, l_end ) )
+      break;
+
+    //! Format: dimension tag "name"
+    UID l_dim, l_tag;
+    if( splitFields( l_beg, l_end, l_fields ) < 3 ||
+        !toNum( l_fields[0], l_dim ) || !toNum( l_fields[1], l_tag ) )
+      continue;
+
+    const char *l_first = static_cast< const char * >(memchr( l_beg, '"', l_end - l_beg ));
+    const char *l_last  = l_end;
+    while( l_last > l_beg && *(l_last - 1) != '"' )
+      l_last--;
+    if( !l_first || l_last - 1 <= l_first )
+      continue;
+
+    std::string l_name( l_first + 1, l_last - 1 );
+
+    //! Surfaces define the box faces
+    if( l_dim == 2 ) {
+      if( l_name == "top" )
+        m_faceMap[l_tag] = Eureka::Face::TOP;
+      else if( l_name == "bottom" )
+        m_faceMap[l_tag] = Eureka::Face::BOTTOM;
+      else if( l_name == "left" )
+        m_faceMap[l_tag] = Eureka::Face::LEFT;
+      else if( l_name == "right" )
+        m_faceMap[l_tag] = Eureka::Face::RIGHT;
+      else if( l_name == "front" )
+        m_faceMap[l_tag] = Eureka::Face::FRONT;
+      else if( l_name == "back" )
+        m_faceMap[l_tag] = Eureka::Face::BACK;
+      else if( l_name == "interface" )
+        m_faceMap[l_tag] = Eureka::Face::INTERFACE;
+      else
+        std::cerr << "Unknown physical surface (" << l_name << "). Ignored.\n";
+
+      continue;
+    }
+
+    //! Volumes define element groups
+    if( l_dim != 3 )
+      continue;
+
+    if( l_name == "matrix" )
+      m_physMap[l_tag] = 0;
+    else if( l_name == "Piston" )
+      m_physMap[l_tag] = 1;
+    else {
+      std::vector< Eureka::Material * >::const_iterator l_it;
+      for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it )
+        if( (*l_it)->m_name == l_name ) {
+          m_physMap[l_tag] = 2 + (l_it - m_matList.begin());
+          break;
+        }
+
+      if( l_it == m_matList.end() )
+        std::cerr << "Unknown physical volume (" << l_name << "). Ignored.\n";
+    }
+  }
+
+  //! Skip $EndPhysicalNames
+  nextLine( l_beg, l_end );
+}
+
+//! ----------------------------------------------------------------------------
+//! Read in (4.1) entities and map them to their first physical tag
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::readEntities() {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  const char *l_pos     = m_mshPos;
+
+  //! Points hold coordinates, the others a bounding box and bounding entities
+  if( Eureka::isBinary( m_mshFormat ) ) {
+    if( (size_t) (l_fileEnd - l_pos) < 4 * sizeof( uint64_t ) )
+      mshError( "$Entities section", l_pos );
+
+    uint64_t l_num[4];
+    for( int l_dim = 0; l_dim < 4; l_dim++ )
+      l_num[l_dim] = readBin< uint64_t >( l_pos );
+
+    for( int l_dim = 0; l_dim < 4; l_dim++ )
+      for( uint64_t l_e = 0; l_e < l_num[l_dim]; l_e++ ) {
+        const char *l_entity = l_pos;
+        size_t l_head = sizeof( int ) + (l_dim ? 6 : 3) * sizeof( real ) + sizeof( uint64_t );
+        if( (size_t) (l_fileEnd - l_pos) < l_head )
+          mshError( "$Entities section", l_entity );
+
+        int l_tag = readBin< int >( l_pos );
+        l_pos += (l_dim ? 6 : 3) * sizeof( real );
+
+        uint64_t l_numPhys = readBin< uint64_t >( l_pos );
+        if( (size_t) (l_fileEnd - l_pos) / sizeof( int ) < l_numPhys + (l_dim ? 2 : 0) )
+          mshError( "$Entities section", l_entity );
+
+        if( l_numPhys ) {
+          const char *l_phys = l_pos;
+          m_entityPhys[std::make_pair( l_dim, l_tag )] = readBin< int >( l_phys );
+        }
+        l_pos += l_numPhys * sizeof( int );
+
+        if( l_dim ) {
+          uint64_t l_numBound = readBin< uint64_t >( l_pos );
+          if( (size_t) (l_fileEnd - l_pos) / sizeof( int ) < l_numBound )
+            mshError( "$Entities section", l_entity );
+
+          l_pos += l_numBound * sizeof( int );
+        }
+      }
+
+    m_mshPos = l_pos;
+    return;
+  }
+
+  const char *l_secEnd = Eureka::findLine( l_pos, l_fileEnd, "$EndEntities" );
+  Eureka::Field l_field;
+
+  //! Read next token as number or skip i_num tokens
+  auto l_read = [&]( long &o_val ) {
+    return Eureka::nextToken( l_pos, l_secEnd, l_field ) && toNum( l_field, o_val );
+  };
+  auto l_skip = [&]( const long &i_num ) {
+    for( long l_i = 0; l_i < i_num; l_i++ )
+      if( !Eureka::nextToken( l_pos, l_secEnd, l_field ) )
+        return false;
+    return true;
+  };
+
+  long l_num[4];
+  for( int l_dim = 0; l_dim < 4; l_dim++ )
+    if( !l_read( l_num[l_dim] ) )
+      mshError( "$Entities section", l_pos );
+
+  for( int l_dim = 0; l_dim < 4; l_dim++ )
+    for( long l_e = 0; l_e < l_num[l_dim]; l_e++ ) {
+      long l_tag, l_numPhys, l_phys, l_numBound;
+      if( !l_read( l_tag ) || !l_skip( l_dim ? 6 : 3 ) || !l_read( l_numPhys ) )
+        mshError( "$Entities section", l_pos );
+
+      for( long l_p = 0; l_p < l_numPhys; l_p++ ) {
+        if( !l_read( l_phys ) )
+          mshError( "$Entities section", l_pos );
+
+        if( l_p == 0 )
+          m_entityPhys[std::make_pair( l_dim, (int) l_tag )] = l_phys;
+      }
+
+      if( l_dim && (!l_read( l_numBound ) || !l_skip( l_numBound )) )
+        mshError( "$Entities section", l_pos );
+    }
+
+  m_mshPos = l_secEnd;
+}
+
+//! ----------------------------------------------------------------------------
+//! Physical tag of (4.1) entity (0: none)
+//! ----------------------------------------------------------------------------
+UID Eureka::WriterBase::entityPhys( const int &i_dim,
+                                    const int &i_tag ) const {
+  std::map< std::pair< int, int >, UID >::const_iterator l_it =
+                                  m_entityPhys.find( std::make_pair( i_dim, i_tag ) );
+
+  return (l_it != m_entityPhys.end()) ? l_it->second : 0;
+}
+
+//! ----------------------------------------------------------------------------
+//! Split section body (from read position up to line starting with i_endTag)
+//! into newline-aligned blocks and move read position to the end tag
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::splitSection( const char                      *i_endTag,
+                                       std::vector< Eureka::MshBlock > &o_blocks ) {
+  const char *l_end    = m_msh.m_data + m_msh.m_size;
+  const char *l_secEnd = Eureka::findLine( m_mshPos, l_end, i_endTag );
+
+  //! A few blocks per thread (for load balance) of at least 1 MB
+  size_t l_num = std::min( (size_t) 4 * m_pool.size(),
+                           std::max( (size_t) 1, (size_t) (l_secEnd - m_mshPos) >> 20 ) );
+
+  //! Streaming parses a few blocks at a time, so they must be small
+  if( m_stream )
+    l_num = std::max( l_num, (size_t) (l_secEnd - m_mshPos) / Eureka::STREAMBYTES + 1 );
+
+  std::vector< const char * > l_bounds;
+  Eureka::splitChunks( m_mshPos, l_secEnd, l_num, l_bounds );
+
+  for( size_t l_b = 0; l_b + 1 < l_bounds.size(); l_b++ ) {
+    o_blocks.push_back( Eureka::MshBlock() );
+    o_blocks.back().m_beg = l_bounds[l_b];
+    o_blocks.back().m_end = l_bounds[l_b + 1];
+  }
+
+  m_mshPos = l_secEnd;
+}
+
+//! ----------------------------------------------------------------------------
+//! Split i_num binary records (of i_block.m_stride bytes) at read position into
+//! blocks like i_block and move read position past them
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::splitRecords( const UID                       &i_num,
+                                       const Eureka::MshBlock          &i_block,
+                                       std::vector< Eureka::MshBlock > &o_blocks ) {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  if( (size_t) (l_fileEnd - m_mshPos) / i_block.m_stride < i_num )
+    mshError( "binary block (truncated)", m_mshPos );
+
+  for( UID l_r = 0; l_r < i_num; l_r += Eureka::MSHRECORDS ) {
+    o_blocks.push_back( i_block );
+    o_blocks.back().m_num = std::min( Eureka::MSHRECORDS, i_num - l_r );
+    o_blocks.back().m_beg = m_mshPos + l_r * i_block.m_stride;
+    o_blocks.back().m_end = o_blocks.back().m_beg + o_blocks.back().m_num * i_block.m_stride;
+  }
+
+  m_mshPos += i_num * i_block.m_stride;
+}
+
+//! ----------------------------------------------------------------------------
+//! Check parsed blocks (in file order) for errors
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::checkBlocks( const char                            *i_what,
+                                      const std::vector< Eureka::MshBlock > &i_blocks ) const {
+  std::vector< Eureka::MshBlock >::const_iterator l_it;
+  for( l_it = i_blocks.begin(); l_it != i_blocks.end(); ++l_it )
+    if( l_it->m_errPos )
+      mshError( i_what, l_it->m_errPos );
+}
+
+//! ----------------------------------------------------------------------------
+//! Split $Nodes section into blocks (read position is past the $Nodes line)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::splitNodes( std::vector< Eureka::MshBlock > &o_blocks ) {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  const char *l_line    = m_mshPos;
+  const char *l_beg, *l_end;
+  Eureka::Field l_fields[Eureka::MAXFIELDS];
+
+  if( m_mshFormat == Eureka::MshFormat::V22_ASCII ||
+      m_mshFormat == Eureka::MshFormat::V22_BINARY ) {
+    //! Get number of nodes from first line
+    if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 1 ||
+        !toNum( l_fields[0], m_numOfNodes ) )
+      mshError( "$Nodes section", l_line );
+
+    if( m_mshFormat == Eureka::MshFormat::V22_ASCII ) {
+      splitSection( "$EndNodes", o_blocks );
+      return;
+    }
+
+    //! Binary records: ID (int) and coordinates
+    Eureka::MshBlock l_block;
+    l_block.m_stride = sizeof( int ) + 3 * sizeof( real );
+    splitRecords( m_numOfNodes, l_block, o_blocks );
+    return;
+  }
+
+  //! 4.1: number of entity blocks, nodes and min/max node tag, then per entity
+  //! block (dimension, entity tag, parametric, number of nodes) all node tags
+  //! followed by all coordinates (and parametric coordinates)
+  UID l_numBlocks;
+  if( m_mshFormat == Eureka::MshFormat::V41_BINARY ) {
+    if( (size_t) (l_fileEnd - m_mshPos) < 4 * sizeof( uint64_t ) )
+      mshError( "$Nodes section", l_line );
+
+    l_numBlocks  = readBin< uint64_t >( m_mshPos );
+    m_numOfNodes = readBin< uint64_t >( m_mshPos );
+    m_mshPos    += 2 * sizeof( uint64_t );
+  }
+  else if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 4 ||
+           !toNum( l_fields[0], l_numBlocks ) || !toNum( l_fields[1], m_numOfNodes ) )
+    mshError( "$Nodes section", l_line );
+
+  for( UID l_b = 0; l_b < l_numBlocks; l_b++ ) {
+    l_line = m_mshPos;
+    int l_dim, l_tag, l_param;
+    UID l_num;
+
+    if( m_mshFormat == Eureka::MshFormat::V41_BINARY ) {
+      if( (size_t) (l_fileEnd - m_mshPos) < 3 * sizeof( int ) + sizeof( uint64_t ) )
+        mshError( "$Nodes section", l_line );
+
+      l_dim   = readBin< int >( m_mshPos );
+      l_tag   = readBin< int >( m_mshPos );
+      l_param = readBin< int >( m_mshPos );
+      l_num   = readBin< uint64_t >( m_mshPos );
+
+      //! Tags (size_t) and coordinates (3 reals plus one per parametric dim)
+      size_t l_stride = (3 + (l_param ? l_dim : 0)) * sizeof( real );
+      if( (size_t) (l_fileEnd - m_mshPos) / (sizeof( uint64_t ) + l_stride) < l_num )
+        mshError( "binary block (truncated)", l_line );
+
+      const char *l_tags   = m_mshPos;
+      const char *l_coords = m_mshPos + l_num * sizeof( uint64_t );
+      for( UID l_r = 0; l_r < l_num; l_r += Eureka::MSHRECORDS ) {
+        Eureka::MshBlock l_block;
+        l_block.m_num    = std::min( Eureka::MSHRECORDS, l_num - l_r );
+        l_block.m_stride = l_stride;
+        l_block.m_beg    = l_tags + l_r * sizeof( uint64_t );
+        l_block.m_end    = l_block.m_beg + l_block.m_num * sizeof( uint64_t );
+        l_block.m_beg2   = l_coords + l_r * l_stride;
+        l_block.m_end2   = l_block.m_beg2 + l_block.m_num * l_stride;
+        o_blocks.push_back( l_block );
+      }
+
+      m_mshPos = l_coords + l_num * l_stride;
+      continue;
+    }
+
+    if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 4 ||
+        !toNum( l_fields[0], l_dim ) || !toNum( l_fields[1], l_tag ) ||
+        !toNum( l_fields[2], l_param ) || !toNum( l_fields[3], l_num ) )
+      mshError( "$Nodes section", l_line );
+
+    //! Node tags (one per line)
+    size_t l_first = o_blocks.size();
+    for( UID l_r = 0; l_r < l_num; l_r += Eureka::MSHRECORDS ) {
+      Eureka::MshBlock l_block;
+      l_block.m_num = std::min( Eureka::MSHRECORDS, l_num - l_r );
+      l_block.m_beg = m_mshPos;
+      if( !Eureka::skipLines( m_mshPos, l_fileEnd, l_block.m_num ) )
+        mshError( "$Nodes section (truncated)", l_block.m_beg );
+
+      l_block.m_end = m_mshPos;
+      o_blocks.push_back( l_block );
+    }
+
+    //! Coordinates of the same nodes (one node per line)
+    for( size_t l_i = l_first; l_i < o_blocks.size(); l_i++ ) {
+      o_blocks[l_i].m_beg2 = m_mshPos;
+      if( !Eureka::skipLines( m_mshPos, l_fileEnd, o_blocks[l_i].m_num ) )
+        mshError( "$Nodes section (truncated)", o_blocks[l_i].m_beg2 );
+
+      o_blocks[l_i].m_end2 = m_mshPos;
+    }
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Split $Elements section into blocks (read position is past $Elements line)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::splitElems( std::vector< Eureka::MshBlock > &o_blocks ) {
+  const char *l_fileEnd = m_msh.m_data + m_msh.m_size;
+  const char *l_line    = m_mshPos;
+  const char *l_beg, *l_end;
+  Eureka::Field l_fields[Eureka::MAXFIELDS];
+
+  if( m_mshFormat == Eureka::MshFormat::V22_ASCII ||
+      m_mshFormat == Eureka::MshFormat::V22_BINARY ) {
+    //! Get number of elements from first line
+    UID l_numElems;
+    if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 1 ||
+        !toNum( l_fields[0], l_numElems ) )
+      mshError( "$Elements section", l_line );
+
+    if( m_mshFormat == Eureka::MshFormat::V22_ASCII ) {
+      splitSection( "$EndElements", o_blocks );
+      return;
+    }
+
+    //! Binary: header (type, number of elements, number of tags) followed by
+    //! records of ID, tags and nodes (all int)
+    for( UID l_done = 0; l_done < l_numElems; ) {
+      l_line = m_mshPos;
+      if( (size_t) (l_fileEnd - m_mshPos) < 3 * sizeof( int ) )
+        mshError( "$Elements section", l_line );
+
+      Eureka::MshBlock l_block;
+      l_block.m_type   = readBin< int >( m_mshPos );
+      int l_numFollow  = readBin< int >( m_mshPos );
+      int l_numTags    = readBin< int >( m_mshPos );
+
+      unsigned int l_numNodes = Eureka::numTypeNodes( l_block.m_type );
+      if( !l_numNodes || l_numFollow <= 0 || l_numTags < 0 )
+        mshError( "$Elements section", l_line );
+
+      l_block.m_numTags = l_numTags;
+      l_block.m_stride  = (1 + l_numTags + l_numNodes) * sizeof( int );
+      splitRecords( l_numFollow, l_block, o_blocks );
+
+      l_done += l_numFollow;
+    }
+    return;
+  }
+
+  //! 4.1: number of entity blocks, elements and min/max element tag, then per
+  //! entity block (dimension, entity tag, type, number of elements) records of
+  //! element tag and nodes
+  UID l_numBlocks;
+  if( m_mshFormat == Eureka::MshFormat::V41_BINARY ) {
+    if( (size_t) (l_fileEnd - m_mshPos) < 4 * sizeof( uint64_t ) )
+      mshError( "$Elements section", l_line );
+
+    l_numBlocks = readBin< uint64_t >( m_mshPos );
+    m_mshPos   += 3 * sizeof( uint64_t );
+  }
+  else if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 4 ||
+           !toNum( l_fields[0], l_numBlocks ) )
+    mshError( "$Elements section", l_line );
+
+  for( UID l_b = 0; l_b < l_numBlocks; l_b++ ) {
+    l_line = m_mshPos;
+    int l_dim, l_tag;
+    UID l_num;
+    Eureka::MshBlock l_block;
+
+    if( m_mshFormat == Eureka::MshFormat::V41_BINARY ) {
+      if( (size_t) (l_fileEnd - m_mshPos) < 3 * sizeof( int ) + sizeof( uint64_t ) )
+        mshError( "$Elements section", l_line );
+
+      l_dim          = readBin< int >( m_mshPos );
+      l_tag          = readBin< int >( m_mshPos );
+      l_block.m_type = readBin< int >( m_mshPos );
+      l_num          = readBin< uint64_t >( m_mshPos );
+
+      unsigned int l_numNodes = Eureka::numTypeNodes( l_block.m_type );
+      if( !l_numNodes )
+        mshError( "$Elements section", l_line );
+
+      l_block.m_phys   = entityPhys( l_dim, l_tag );
+      l_block.m_stride = (1 + l_numNodes) * sizeof( uint64_t );
+      splitRecords( l_num, l_block, o_blocks );
+      continue;
+    }
+
+    if( !nextLine( l_beg, l_end ) || splitFields( l_beg, l_end, l_fields ) != 4 ||
+        !toNum( l_fields[0], l_dim ) || !toNum( l_fields[1], l_tag ) ||
+        !toNum( l_fields[2], l_block.m_type ) || !toNum( l_fields[3], l_num ) )
+      mshError( "$Elements section", l_line );
+
+    l_block.m_phys = entityPhys( l_dim, l_tag );
+
+    //! Elements (one per line)
+    for( UID l_r = 0; l_r < l_num; l_r += Eureka::MSHRECORDS ) {
+      o_blocks.push_back( l_block );
+      o_blocks.back().m_num = std::min( Eureka::MSHRECORDS, l_num - l_r );
+      o_blocks.back().m_beg = m_mshPos;
+      if( !Eureka::skipLines( m_mshPos, l_fileEnd, o_blocks.back().m_num ) )
+        mshError( "$Elements section (truncated)", o_blocks.back().m_beg );
+
+      o_blocks.back().m_end = m_mshPos;
+    }
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse nodes of block (runs concurrently on different blocks)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::parseNodes( Eureka::MshBlock &io_block ) const {
+  Eureka::Field l_f[Eureka::MAXFIELDS];
+  io_block.m_ids.reserve( io_block.m_num );
+  io_block.m_coords.reserve( io_block.m_num );
+
+  if( m_mshFormat == Eureka::MshFormat::V22_ASCII ) {
+    const char *l_pos = io_block.m_beg;
+
+    while( l_pos < io_block.m_end ) {
+      const char *l_eol = Eureka::findEol( l_pos, io_block.m_end );
+
+      //! We should have exactly 4 columns
+      if( splitFields( l_pos, l_eol, l_f ) == 4 ) {
+        UID l_id;
+        real l_x, l_y, l_z;
+        if( !toNum( l_f[0], l_id ) || !toNum( l_f[1], l_x ) ||
+            !toNum( l_f[2], l_y )  || !toNum( l_f[3], l_z ) ) {
+          io_block.m_errPos = l_pos;
+          return;
+        }
+
+        io_block.m_ids.push_back( l_id );
+        io_block.m_coords.push_back( geo::Vector( l_x, l_y, l_z ) );
+      }
+
+      l_pos = l_eol + 1;
+    }
+  }
+
+  else if( m_mshFormat == Eureka::MshFormat::V41_ASCII ) {
+    const char *l_tagPos = io_block.m_beg, *l_coordPos = io_block.m_beg2;
+
+    for( UID l_r = 0; l_r < io_block.m_num; l_r++ ) {
+      //! Node tag line
+      UID l_id;
+      const char *l_eol = Eureka::findEol( l_tagPos, io_block.m_end );
+      if( splitFields( l_tagPos, l_eol, l_f ) != 1 || !toNum( l_f[0], l_id ) ) {
+        io_block.m_errPos = l_tagPos;
+        return;
+      }
+      l_tagPos = l_eol + 1;
+
+      //! Coordinate line (parametric coordinates are ignored)
+      real l_x, l_y, l_z;
+      l_eol = Eureka::findEol( l_coordPos, io_block.m_end2 );
+      if( splitFields( l_coordPos, l_eol, l_f ) < 3 || !toNum( l_f[0], l_x ) ||
+          !toNum( l_f[1], l_y ) || !toNum( l_f[2], l_z ) ) {
+        io_block.m_errPos = l_coordPos;
+        return;
+      }
+      l_coordPos = l_eol + 1;
+
+      io_block.m_ids.push_back( l_id );
+      io_block.m_coords.push_back( geo::Vector( l_x, l_y, l_z ) );
+    }
+  }
+
+  //! Binary records are read straight into the typed arrays
+  else {
+    bool l_v22 = (m_mshFormat == Eureka::MshFormat::V22_BINARY);
+
+    for( UID l_r = 0; l_r < io_block.m_num; l_r++ ) {
+      const char *l_pos;
+      if( l_v22 ) {
+        l_pos = io_block.m_beg + l_r * io_block.m_stride;
+        io_block.m_ids.push_back( readBin< int >( l_pos ) );
+      }
+      else {
+        l_pos = io_block.m_beg + l_r * sizeof( uint64_t );
+        io_block.m_ids.push_back( readBin< uint64_t >( l_pos ) );
+        l_pos = io_block.m_beg2 + l_r * io_block.m_stride;
+      }
+
+      real l_xyz[3];
+      memcpy( l_xyz, l_pos, sizeof( l_xyz ) );
+      io_block.m_coords.push_back( geo::Vector( l_xyz[0], l_xyz[1], l_xyz[2] ) );
+    }
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Add parsed triangle (type 2) or tet (type 4) to block
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::addElem( Eureka::MshBlock &io_block,
+                                  const long       &i_type,
+                                  const UID        &i_phys,
+                                  const UID        (&i_nodes)[4] ) const {
+  //! Triangles on tagged box faces mark their nodes
+  if( i_type == 2 ) {
+    std::map< UID, Eureka::Face >::const_iterator l_faceIt = m_faceMap.find( i_phys );
+    if( l_faceIt != m_faceMap.end() )
+      for( int l_i = 0; l_i < 3; l_i++ )
+        io_block.m_faceNodes.push_back( std::make_pair( i_nodes[l_i], l_faceIt->second ) );
+
+    return;
+  }
+
+  //! Tets without a known physical volume need the particle grid
+  if( !io_block.m_untagged && m_physMap.find( i_phys ) == m_physMap.end() )
+    io_block.m_untagged = true;
+
+  io_block.m_tets.push_back( i_phys );
+  io_block.m_tets.insert( io_block.m_tets.end(), i_nodes, i_nodes + 4 );
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse elements of block (runs concurrently on different blocks), only
+//! triangles and tets are kept
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::parseElems( Eureka::MshBlock &io_block ) const {
+  Eureka::Field l_f[Eureka::MAXFIELDS];
+  UID l_n[4] = { 0, 0, 0, 0 };
+
+  //! 2.2 ASCII lines: ID, type, number of tags, tags (physical first), nodes
+  if( m_mshFormat == Eureka::MshFormat::V22_ASCII ) {
+    const char *l_pos = io_block.m_beg;
+
+    while( l_pos < io_block.m_end ) {
+      const char *l_line = l_pos;
+      const char *l_eol  = Eureka::findEol( l_pos, io_block.m_end );
+      int l_numFields    = splitFields( l_pos, l_eol, l_f );
+      l_pos = l_eol + 1;
+
+      if( l_numFields < 3 || !(l_f[1] == "2" || l_f[1] == "4") )
+        continue;
+
+      long l_type = (l_f[1] == "2") ? 2 : 4;
+      int l_numNodes = (l_type == 2) ? 3 : 4;
+      UID l_numTags, l_phys = 0;
+      if( !toNum( l_f[2], l_numTags ) || l_numFields != (long) (3 + l_numTags + l_numNodes) ||
+          (l_numTags && !toNum( l_f[3], l_phys )) ) {
+        io_block.m_errPos = l_line;
+        return;
+      }
+
+      for( int l_i = 0; l_i < l_numNodes; l_i++ )
+        if( !toNum( l_f[3 + l_numTags + l_i], l_n[l_i] ) ) {
+          io_block.m_errPos = l_line;
+          return;
+        }
+
+      addElem( io_block, l_type, l_phys, l_n );
+    }
+
+    return;
+  }
+
+  if( io_block.m_type != 2 && io_block.m_type != 4 )
+    return;
+
+  int l_numNodes = (io_block.m_type == 2) ? 3 : 4;
+
+  //! 4.1 ASCII lines: element tag, nodes
+  if( m_mshFormat == Eureka::MshFormat::V41_ASCII ) {
+    const char *l_pos = io_block.m_beg;
+
+    for( UID l_r = 0; l_r < io_block.m_num; l_r++ ) {
+      const char *l_eol = Eureka::findEol( l_pos, io_block.m_end );
+      bool l_ok = (splitFields( l_pos, l_eol, l_f ) == 1 + l_numNodes);
+
+      for( int l_i = 0; l_ok && l_i < l_numNodes; l_i++ )
+        l_ok = toNum( l_f[1 + l_i], l_n[l_i] );
+
+      if( !l_ok ) {
+        io_block.m_errPos = l_pos;
+        return;
+      }
+
+      addElem( io_block, io_block.m_type, io_block.m_phys, l_n );
+      l_pos = l_eol + 1;
+    }
+
+    return;
+  }
+
+  //! Binary records are read straight into the typed arrays
+  for( UID l_r = 0; l_r < io_block.m_num; l_r++ ) {
+    const char *l_pos = io_block.m_beg + l_r * io_block.m_stride;
+    UID l_phys = io_block.m_phys;
+
+    if( m_mshFormat == Eureka::MshFormat::V22_BINARY ) {
+      l_pos += sizeof( int );
+      if( io_block.m_numTags ) {
+        const char *l_tags = l_pos;
+        l_phys = readBin< int >( l_tags );
+      }
+
+      l_pos += io_block.m_numTags * sizeof( int );
+      for( int l_i = 0; l_i < l_numNodes; l_i++ )
+        l_n[l_i] = readBin< int >( l_pos );
+    }
+    else {
+      l_pos += sizeof( uint64_t );
+      for( int l_i = 0; l_i < l_numNodes; l_i++ )
+        l_n[l_i] = readBin< uint64_t >( l_pos );
+    }
+
+    addElem( io_block, io_block.m_type, l_phys, l_n );
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Largest node ID and number of elements (of any type) from the headers of
+//! the $Nodes and $Elements sections of mapped msh file, without parsing them
+//! (2.2 headers only hold the number of nodes, a lower bound on the largest
+//! ID); returns false if the headers can't be read
+//! ----------------------------------------------------------------------------
+bool Eureka::mshCounts( const Eureka::MappedFile &i_msh,
+                        UID                      &o_maxNode,
+                        UID                      &o_numElems ) {
+  const char *l_fileEnd = i_msh.m_data + i_msh.m_size;
+  const char *l_pos     = Eureka::findLine( i_msh.m_data, l_fileEnd, "$MeshFormat" );
+  Eureka::Field l_fields[Eureka::MAXFIELDS];
+
+  //! Format: version file-type data-size
+  if( !Eureka::skipLines( l_pos, l_fileEnd, 1 ) ||
+      Eureka::splitFields( l_pos, Eureka::findEol( l_pos, l_fileEnd ), l_fields ) != 3 )
+    return false;
+
+  bool l_v41    = (l_fields[0] == "4.1");
+  bool l_binary = (l_fields[1] == "1");
+
+  //! Section header: (2.2) count, (4.1) blocks count min-tag max-tag
+  auto l_header = [&]( const char *i_name, UID &o_count, UID &o_maxTag ) {
+    l_pos = Eureka::findLine( l_pos, l_fileEnd, i_name );
+    if( !Eureka::skipLines( l_pos, l_fileEnd, 1 ) || l_pos == l_fileEnd )
+      return false;
+
+    if( l_v41 && l_binary ) {
+      if( (size_t) (l_fileEnd - l_pos) < 4 * sizeof( uint64_t ) )
+        return false;
+
+      const char *l_vals = l_pos;
+      readBin< uint64_t >( l_vals );
+      o_count  = readBin< uint64_t >( l_vals );
+      readBin< uint64_t >( l_vals );
+      o_maxTag = readBin< uint64_t >( l_vals );
+      return true;
+    }
+
+    int l_num = Eureka::splitFields( l_pos, Eureka::findEol( l_pos, l_fileEnd ), l_fields );
+    if( l_v41 )
+      return (l_num == 4 && toNum( l_fields[1], o_count ) && toNum( l_fields[3], o_maxTag ));
+
+    return (l_num == 1 && toNum( l_fields[0], o_count ) && toNum( l_fields[0], o_maxTag ));
+  };
+
+  UID l_numNodes, l_maxElem;
+  return (l_header( "$Nodes", l_numNodes, o_maxNode ) &&
+          l_header( "$Elements", o_numElems, l_maxElem ));
+}
\ No newline at end of file
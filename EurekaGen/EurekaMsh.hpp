@@ -0,0 +1,123 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Gmsh .msh (2.2 and 4.1, ASCII and binary) layouts and parse blocks.
+ **/
+
+#ifndef EUREKA_MSH_HPP
+#define EUREKA_MSH_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "EurekaConstants.h"
+#include "../GeoGen/Geo.hpp"
+
+namespace Eureka {
+  //! .msh layouts (from version, file-type of $MeshFormat)
+  enum class MshFormat : unsigned char {
+    V22_ASCII,
+    V22_BINARY,
+    V41_ASCII,
+    V41_BINARY
+  };
+
+  //! Most records (lines or binary records) per block of a 4.1/binary section
+  const UID MSHRECORDS = 1 << 16;
+
+  //! Most bytes of a 2.2 ASCII block in streaming mode
+  const size_t STREAMBYTES = 1 << 23;
+
+  struct MshBlock;
+  struct MappedFile;
+
+  inline bool isBinary( const Eureka::MshFormat &i_format );
+
+  inline unsigned int numTypeNodes( const long &i_type );
+
+  bool mshCounts( const Eureka::MappedFile &i_msh,
+                  UID                      &o_maxNode,
+                  UID                      &o_numElems );
+}
+
+//! ----------------------------------------------------------------------------
+//! Piece of a $Nodes/$Elements section, parsed independently of the others
+//! ----------------------------------------------------------------------------
+struct Eureka::MshBlock {
+  //! Lines (ASCII) or records (binary) of block; 4.1 node blocks keep their
+  //! node tags in [m_beg, m_end) and coordinates in [m_beg2, m_end2)
+  const char *m_beg, *m_end, *m_beg2, *m_end2;
+
+  //! Number of records (0 for 2.2 ASCII chunks), size of a binary record,
+  //! element type, number of tags (2.2 binary) and physical tag (4.1)
+  UID          m_num;
+  size_t       m_stride;
+  long         m_type;
+  unsigned int m_numTags;
+  UID          m_phys;
+
+  //! First malformed line/record (nullptr: none)
+  const char *m_errPos;
+
+  //! Parsed nodes (ID, coordinates and predicates, see EurekaGroups.hpp)
+  std::vector< UID >         m_ids;
+  std::vector< geo::Vector > m_coords;
+  std::vector< uint16_t >    m_preds;
+
+  //! Parsed tets (physical tag and 4 nodes each), whether any of them lacks
+  //! a known physical volume, and nodes of tagged triangles
+  std::vector< UID >                             m_tets;
+  bool                                           m_untagged;
+  std::vector< std::pair< UID, unsigned char > > m_faceNodes;
+
+  MshBlock() : m_beg(nullptr), m_end(nullptr), m_beg2(nullptr), m_end2(nullptr),
+               m_num(0), m_stride(0), m_type(0), m_numTags(0), m_phys(0),
+               m_errPos(nullptr), m_untagged(false) {}
+};
+
+//! ----------------------------------------------------------------------------
+//! Check if layout is binary
+//! ----------------------------------------------------------------------------
+inline bool Eureka::isBinary( const Eureka::MshFormat &i_format ) {
+  return (i_format == Eureka::MshFormat::V22_BINARY ||
+          i_format == Eureka::MshFormat::V41_BINARY);
+}
+
+//! ----------------------------------------------------------------------------
+//! Nodes of Gmsh element type (0: unknown type)
+//! ----------------------------------------------------------------------------
+inline unsigned int Eureka::numTypeNodes( const long &i_type ) {
+  static const unsigned int l_nodes[32] = {  0,  2,  3,  4,  4,  8,  6,  5,
+                                             3,  6,  9, 10, 27, 18, 14,  1,
+                                             8, 20, 15, 13,  9, 10, 12, 15,
+                                            15, 21,  4,  5,  6, 20, 35, 56 };
+
+  return (i_type > 0 && i_type < 32) ? l_nodes[i_type] : 0;
+}
+
+#endif
\ No newline at end of file
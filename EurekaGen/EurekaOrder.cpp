@@ -0,0 +1,456 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Node and element orderings: Reverse Cuthill-McKee and space-filling curves.
+ **/
+
+#include <algorithm>
+#include <atomic>
+
+#include "EurekaOrder.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Number of ranges to split i_num items into for the pool (range t is
+//! [t * i_num / n, (t + 1) * i_num / n))
+//! ----------------------------------------------------------------------------
+static size_t numRanges( const size_t             &i_num,
+                         const Eureka::ThreadPool &i_pool ) {
+  return std::max( (size_t) 1, std::min( (size_t) 4 * i_pool.size(), i_num / 4096 ) );
+}
+
+//! ----------------------------------------------------------------------------
+//! Spread the low 21 bits of i_x to every third bit
+//! ----------------------------------------------------------------------------
+static uint64_t spreadBits( const uint32_t &i_x ) {
+  uint64_t l_x = i_x & 0x1fffff;
+  l_x = (l_x | l_x << 32) & 0x1f00000000ffffULL;
+  l_x = (l_x | l_x << 16) & 0x1f0000ff0000ffULL;
+  l_x = (l_x | l_x <<  8) & 0x100f00f00f00f00fULL;
+  l_x = (l_x | l_x <<  4) & 0x10c30c30c30c30c3ULL;
+  l_x = (l_x | l_x <<  2) & 0x1249249249249249ULL;
+  return l_x;
+}
+
+//! ----------------------------------------------------------------------------
+//! Select ordering by name (returns false if unknown)
+//! ----------------------------------------------------------------------------
+bool Eureka::parseOrdering( const std::string &i_name,
+                            Eureka::Ordering  &o_order ) {
+  if( i_name == "none" )
+    o_order = Eureka::Ordering::NONE;
+  else if( i_name == "rcm" )
+    o_order = Eureka::Ordering::RCM;
+  else if( i_name == "morton" )
+    o_order = Eureka::Ordering::MORTON;
+  else if( i_name == "hilbert" )
+    o_order = Eureka::Ordering::HILBERT;
+  else
+    return false;
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Name of ordering
+//! ----------------------------------------------------------------------------
+const char *Eureka::orderingName( const Eureka::Ordering &i_order ) {
+  switch( i_order ) {
+    case Eureka::Ordering::RCM:
+      return "rcm";
+    case Eureka::Ordering::MORTON:
+      return "morton";
+    case Eureka::Ordering::HILBERT:
+      return "hilbert";
+    default:
+      return "none";
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Position of a point (CURVEBITS-bit integer axes) along the Morton or
+//! Hilbert curve
+//! ----------------------------------------------------------------------------
+uint64_t Eureka::curveKey( const Eureka::Ordering &i_curve,
+                           const uint32_t         (&i_axes)[3] ) {
+  uint32_t l_X[3] = { i_axes[0], i_axes[1], i_axes[2] };
+
+  //! Hilbert: transpose axes in place (Skilling, 2004), the key then
+  //! interleaves their bits just like Morton
+  if( i_curve == Eureka::Ordering::HILBERT ) {
+    const uint32_t l_M = 1u << (Eureka::CURVEBITS - 1);
+
+    //! Inverse undo
+    for( uint32_t l_Q = l_M; l_Q > 1; l_Q >>= 1 ) {
+      uint32_t l_P = l_Q - 1;
+      for( int l_i = 0; l_i < 3; l_i++ ) {
+        if( l_X[l_i] & l_Q )
+          l_X[0] ^= l_P;
+        else {
+          uint32_t l_t = (l_X[0] ^ l_X[l_i]) & l_P;
+          l_X[0]   ^= l_t;
+          l_X[l_i] ^= l_t;
+        }
+      }
+    }
+
+    //! Gray encode
+    l_X[1] ^= l_X[0];
+    l_X[2] ^= l_X[1];
+
+    uint32_t l_t = 0;
+    for( uint32_t l_Q = l_M; l_Q > 1; l_Q >>= 1 )
+      if( l_X[2] & l_Q )
+        l_t ^= l_Q - 1;
+
+    for( int l_i = 0; l_i < 3; l_i++ )
+      l_X[l_i] ^= l_t;
+  }
+
+  return (spreadBits( l_X[0] ) << 2) | (spreadBits( l_X[1] ) << 1) | spreadBits( l_X[2] );
+}
+
+//! ----------------------------------------------------------------------------
+//! Stable parallel LSD radix sort of keys, carrying values along (passes whose
+//! digit is the same for every key are skipped)
+//! ----------------------------------------------------------------------------
+void Eureka::radixSort( std::vector< uint64_t > &io_keys,
+                        std::vector< UID >      &io_vals,
+                        Eureka::ThreadPool      &io_pool ) {
+  const size_t l_numDigits = (size_t) 1 << Eureka::RADIXBITS;
+  const uint64_t l_mask = l_numDigits - 1;
+
+  size_t l_num = io_keys.size();
+  size_t l_ranges = numRanges( l_num, io_pool );
+
+  std::vector< uint64_t > l_keys( l_num );
+  std::vector< UID >      l_vals( l_num );
+
+  //! Digit counts, then scatter positions, of every range
+  std::vector< size_t > l_counts( l_ranges * l_numDigits );
+
+  for( int l_shift = 0; l_shift < 64; l_shift += Eureka::RADIXBITS ) {
+    std::fill( l_counts.begin(), l_counts.end(), 0 );
+
+    io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+      size_t *l_count = &l_counts[i_r * l_numDigits];
+      for( size_t l_i = i_r * l_num / l_ranges; l_i < (i_r + 1) * l_num / l_ranges; l_i++ )
+        l_count[(io_keys[l_i] >> l_shift) & l_mask]++;
+    } );
+
+    //! Digits in order, ranges in order within a digit
+    size_t l_pos = 0;
+    bool l_skip = false;
+    for( size_t l_d = 0; l_d < l_numDigits; l_d++ ) {
+      size_t l_total = 0;
+      for( size_t l_r = 0; l_r < l_ranges; l_r++ ) {
+        size_t l_count = l_counts[l_r * l_numDigits + l_d];
+        l_counts[l_r * l_numDigits + l_d] = l_pos;
+        l_pos   += l_count;
+        l_total += l_count;
+      }
+
+      if( l_total == l_num )
+        l_skip = true;
+    }
+
+    if( l_skip )
+      continue;
+
+    io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+      size_t *l_next = &l_counts[i_r * l_numDigits];
+      for( size_t l_i = i_r * l_num / l_ranges; l_i < (i_r + 1) * l_num / l_ranges; l_i++ ) {
+        size_t l_to = l_next[(io_keys[l_i] >> l_shift) & l_mask]++;
+        l_keys[l_to] = io_keys[l_i];
+        l_vals[l_to] = io_vals[l_i];
+      }
+    } );
+
+    io_keys.swap( l_keys );
+    io_vals.swap( l_vals );
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Order of points along the Morton or Hilbert curve through their bounding
+//! cube (o_order[i] is the index of i-th point on the curve)
+//! ----------------------------------------------------------------------------
+void Eureka::curveOrder( const Eureka::Ordering          &i_curve,
+                         const std::vector< geo::Vector > &i_points,
+                         Eureka::ThreadPool              &io_pool,
+                         std::vector< UID >              &o_order ) {
+  size_t l_num = i_points.size();
+  o_order.resize( l_num );
+  if( !l_num )
+    return;
+
+  //! Bounding cube
+  geo::Vector l_min = i_points[0], l_max = i_points[0];
+  std::vector< geo::Vector >::const_iterator l_it;
+  for( l_it = i_points.begin(); l_it != i_points.end(); ++l_it ) {
+    l_min.m_x = std::min( l_min.m_x, l_it->m_x );
+    l_min.m_y = std::min( l_min.m_y, l_it->m_y );
+    l_min.m_z = std::min( l_min.m_z, l_it->m_z );
+    l_max.m_x = std::max( l_max.m_x, l_it->m_x );
+    l_max.m_y = std::max( l_max.m_y, l_it->m_y );
+    l_max.m_z = std::max( l_max.m_z, l_it->m_z );
+  }
+
+  real l_side = std::max( { l_max.m_x - l_min.m_x, l_max.m_y - l_min.m_y,
+                            l_max.m_z - l_min.m_z } );
+  real l_cells = (real) ((1u << Eureka::CURVEBITS) - 1);
+  real l_scale = (l_side > 0.0) ? l_cells / l_side : 0.0;
+
+  //! Keys of points in parallel
+  std::vector< uint64_t > l_keys( l_num );
+  size_t l_ranges = numRanges( l_num, io_pool );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_i = i_r * l_num / l_ranges; l_i < (i_r + 1) * l_num / l_ranges; l_i++ ) {
+      const geo::Vector &l_P = i_points[l_i];
+      uint32_t l_axes[3] = {
+        (uint32_t) std::min( l_cells, (l_P.m_x - l_min.m_x) * l_scale ),
+        (uint32_t) std::min( l_cells, (l_P.m_y - l_min.m_y) * l_scale ),
+        (uint32_t) std::min( l_cells, (l_P.m_z - l_min.m_z) * l_scale )
+      };
+
+      l_keys[l_i]  = Eureka::curveKey( i_curve, l_axes );
+      o_order[l_i] = l_i;
+    }
+  } );
+
+  Eureka::radixSort( l_keys, o_order, io_pool );
+}
+
+//! ----------------------------------------------------------------------------
+//! Build from tets (4 vertex indices < i_num per tet) connecting all corners
+//! ----------------------------------------------------------------------------
+void Eureka::Graph::build( const UID                &i_num,
+                           const std::vector< UID > &i_tets,
+                           Eureka::ThreadPool       &io_pool ) {
+  size_t l_numTets = i_tets.size() / 4;
+  size_t l_ranges  = numRanges( l_numTets, io_pool );
+
+  //! Count edges (repeats included) of every vertex
+  std::vector< std::atomic< UID > > l_cursor( i_num );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_i = 4 * (i_r * l_numTets / l_ranges);
+         l_i < 4 * ((i_r + 1) * l_numTets / l_ranges); l_i++ )
+      l_cursor[i_tets[l_i]].fetch_add( 3, std::memory_order_relaxed );
+  } );
+
+  m_offsets.assign( i_num + 1, 0 );
+  for( UID l_v = 0; l_v < i_num; l_v++ ) {
+    m_offsets[l_v + 1] = m_offsets[l_v] + l_cursor[l_v].load( std::memory_order_relaxed );
+    l_cursor[l_v].store( m_offsets[l_v], std::memory_order_relaxed );
+  }
+
+  //! Scatter edges
+  std::vector< UID > l_adj( m_offsets[i_num] );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_t = i_r * l_numTets / l_ranges; l_t < (i_r + 1) * l_numTets / l_ranges; l_t++ )
+      for( int l_k = 0; l_k < 4; l_k++ ) {
+        UID l_v = i_tets[4 * l_t + l_k];
+        for( int l_j = 0; l_j < 4; l_j++ )
+          if( l_j != l_k )
+            l_adj[l_cursor[l_v].fetch_add( 1, std::memory_order_relaxed )] = i_tets[4 * l_t + l_j];
+      }
+  } );
+
+  //! Sort rows and drop repeats
+  std::vector< UID > l_offsets( i_num + 1, 0 );
+  l_ranges = numRanges( i_num, io_pool );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( UID l_v = i_r * i_num / l_ranges; l_v < (i_r + 1) * i_num / l_ranges; l_v++ ) {
+      std::vector< UID >::iterator l_beg = l_adj.begin() + m_offsets[l_v];
+      std::vector< UID >::iterator l_end = l_adj.begin() + m_offsets[l_v + 1];
+      std::sort( l_beg, l_end );
+      l_offsets[l_v + 1] = std::unique( l_beg, l_end ) - l_beg;
+    }
+  } );
+
+  for( UID l_v = 0; l_v < i_num; l_v++ )
+    l_offsets[l_v + 1] += l_offsets[l_v];
+
+  //! Compact rows
+  m_adj.resize( l_offsets[i_num] );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( UID l_v = i_r * i_num / l_ranges; l_v < (i_r + 1) * i_num / l_ranges; l_v++ )
+      std::copy( l_adj.begin() + m_offsets[l_v],
+                 l_adj.begin() + m_offsets[l_v] + (l_offsets[l_v + 1] - l_offsets[l_v]),
+                 m_adj.begin() + l_offsets[l_v] );
+  } );
+
+  m_offsets.swap( l_offsets );
+}
+
+//! ----------------------------------------------------------------------------
+//! Build the dual of tets (4 vertex indices < i_num per tet): tets are the
+//! vertices, connected if they share a face
+//! ----------------------------------------------------------------------------
+void Eureka::Graph::buildDual( const UID                &i_num,
+                               const std::vector< UID > &i_tets,
+                               Eureka::ThreadPool       &io_pool ) {
+  const UID l_none = (UID) -1;
+  UID l_numTets = i_tets.size() / 4;
+
+  //! Tets of every vertex (sorted)
+  std::vector< UID > l_offsets( i_num + 1, 0 ), l_tetsOf( i_tets.size() );
+  for( size_t l_i = 0; l_i < i_tets.size(); l_i++ )
+    l_offsets[i_tets[l_i] + 1]++;
+  for( UID l_v = 0; l_v < i_num; l_v++ )
+    l_offsets[l_v + 1] += l_offsets[l_v];
+
+  std::vector< UID > l_next( l_offsets.begin(), l_offsets.end() - 1 );
+  for( size_t l_i = 0; l_i < i_tets.size(); l_i++ )
+    l_tetsOf[l_next[i_tets[l_i]]++] = l_i / 4;
+
+  //! Neighbour across each face (the one opposite corner k), if any
+  std::vector< UID > l_nbrs( 4 * l_numTets, l_none );
+  size_t l_ranges = numRanges( l_numTets, io_pool );
+  io_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( UID l_t = i_r * l_numTets / l_ranges; l_t < (i_r + 1) * l_numTets / l_ranges; l_t++ )
+      for( int l_k = 0; l_k < 4; l_k++ ) {
+        UID l_a = i_tets[4 * l_t + (l_k + 1) % 4];
+        UID l_b = i_tets[4 * l_t + (l_k + 2) % 4];
+        UID l_c = i_tets[4 * l_t + (l_k + 3) % 4];
+
+        //! Other tet having all three face corners
+        for( UID l_i = l_offsets[l_a]; l_i < l_offsets[l_a + 1]; l_i++ ) {
+          UID l_s = l_tetsOf[l_i];
+          if( l_s != l_t &&
+              std::binary_search( l_tetsOf.begin() + l_offsets[l_b],
+                                  l_tetsOf.begin() + l_offsets[l_b + 1], l_s ) &&
+              std::binary_search( l_tetsOf.begin() + l_offsets[l_c],
+                                  l_tetsOf.begin() + l_offsets[l_c + 1], l_s ) ) {
+            l_nbrs[4 * l_t + l_k] = l_s;
+            break;
+          }
+        }
+      }
+  } );
+
+  //! Compact rows (sorted, without repeats)
+  m_offsets.assign( l_numTets + 1, 0 );
+  m_adj.clear();
+  m_adj.reserve( l_nbrs.size() );
+  for( UID l_t = 0; l_t < l_numTets; l_t++ ) {
+    std::vector< UID >::iterator l_beg = l_nbrs.begin() + 4 * l_t;
+    std::sort( l_beg, l_beg + 4 );
+    for( int l_k = 0; l_k < 4; l_k++ )
+      if( l_beg[l_k] != l_none && (l_k == 0 || l_beg[l_k] != l_beg[l_k - 1]) )
+        m_adj.push_back( l_beg[l_k] );
+    m_offsets[l_t + 1] = m_adj.size();
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Reverse Cuthill-McKee order of the graph (o_order[i] is the i-th vertex),
+//! every connected component starting at a pseudo-peripheral vertex
+//! ----------------------------------------------------------------------------
+void Eureka::rcmOrder( const Eureka::Graph &i_graph,
+                       std::vector< UID >  &o_order ) {
+  const UID l_unseen = (UID) -1;
+  UID l_num = i_graph.size();
+
+  //! Breadth-first level of every vertex and the vertices last reached
+  std::vector< UID > l_level( l_num, l_unseen );
+  std::vector< UID > l_reached;
+
+  //! Level structure rooted at i_root (returns its depth)
+  auto l_levels = [&]( const UID &i_root ) {
+    std::vector< UID >::const_iterator l_it;
+    for( l_it = l_reached.begin(); l_it != l_reached.end(); ++l_it )
+      l_level[*l_it] = l_unseen;
+
+    l_reached.assign( 1, i_root );
+    l_level[i_root] = 0;
+    for( size_t l_h = 0; l_h < l_reached.size(); l_h++ ) {
+      UID l_v = l_reached[l_h];
+      for( UID l_a = i_graph.m_offsets[l_v]; l_a < i_graph.m_offsets[l_v + 1]; l_a++ ) {
+        UID l_w = i_graph.m_adj[l_a];
+        if( l_level[l_w] == l_unseen ) {
+          l_level[l_w] = l_level[l_v] + 1;
+          l_reached.push_back( l_w );
+        }
+      }
+    }
+
+    return l_level[l_reached.back()];
+  };
+
+  auto l_byDegree = [&]( const UID &i_a, const UID &i_b ) {
+    return i_graph.degree( i_a ) < i_graph.degree( i_b );
+  };
+
+  std::vector< bool > l_done( l_num, false );
+  std::vector< UID > l_next;
+  o_order.clear();
+  o_order.reserve( l_num );
+
+  for( UID l_s = 0; l_s < l_num; l_s++ ) {
+    if( l_done[l_s] )
+      continue;
+
+    //! Pseudo-peripheral root (George and Liu): move to the least connected
+    //! vertex of the last level while that deepens the level structure
+    UID l_root  = l_s;
+    UID l_depth = l_levels( l_root );
+    for( ;; ) {
+      UID l_cand = l_reached.back();
+      for( size_t l_i = l_reached.size(); l_i-- > 0 && l_level[l_reached[l_i]] == l_depth; )
+        if( i_graph.degree( l_reached[l_i] ) <= i_graph.degree( l_cand ) )
+          l_cand = l_reached[l_i];
+
+      UID l_candDepth = l_levels( l_cand );
+      if( l_candDepth <= l_depth )
+        break;
+
+      l_root  = l_cand;
+      l_depth = l_candDepth;
+    }
+
+    //! Cuthill-McKee: breadth-first, unvisited neighbours by increasing degree
+    o_order.push_back( l_root );
+    l_done[l_root] = true;
+    for( size_t l_h = o_order.size() - 1; l_h < o_order.size(); l_h++ ) {
+      UID l_v = o_order[l_h];
+
+      l_next.clear();
+      for( UID l_a = i_graph.m_offsets[l_v]; l_a < i_graph.m_offsets[l_v + 1]; l_a++ ) {
+        UID l_w = i_graph.m_adj[l_a];
+        if( !l_done[l_w] ) {
+          l_done[l_w] = true;
+          l_next.push_back( l_w );
+        }
+      }
+
+      std::stable_sort( l_next.begin(), l_next.end(), l_byDegree );
+      o_order.insert( o_order.end(), l_next.begin(), l_next.end() );
+    }
+  }
+
+  std::reverse( o_order.begin(), o_order.end() );
+}
\ No newline at end of file
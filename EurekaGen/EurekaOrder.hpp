@@ -0,0 +1,103 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Node and element orderings: Reverse Cuthill-McKee and space-filling curves.
+ **/
+
+#ifndef EUREKA_ORDER_HPP
+#define EUREKA_ORDER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EurekaConstants.h"
+#include "EurekaThreads.hpp"
+#include "../GeoGen/Geo.hpp"
+
+namespace Eureka {
+  //! Orderings of nodes (or elements)
+  enum class Ordering : unsigned char {
+    NONE,     //! Order of the .msh file
+    RCM,      //! Reverse Cuthill-McKee of the node graph
+    MORTON,   //! Z-order curve through the coordinates
+    HILBERT   //! Hilbert curve through the coordinates
+  };
+
+  //! Bits per axis of a curve key (3 * 21 bits fit in 64)
+  const int CURVEBITS = 21;
+
+  //! Bits sorted per radix sort pass
+  const int RADIXBITS = 8;
+
+  struct Graph;
+
+  bool parseOrdering( const std::string &i_name,
+                      Eureka::Ordering  &o_order );
+
+  const char *orderingName( const Eureka::Ordering &i_order );
+
+  uint64_t curveKey( const Eureka::Ordering &i_curve,
+                     const uint32_t         (&i_axes)[3] );
+
+  void radixSort( std::vector< uint64_t > &io_keys,
+                  std::vector< UID >      &io_vals,
+                  Eureka::ThreadPool      &io_pool );
+
+  void curveOrder( const Eureka::Ordering          &i_curve,
+                   const std::vector< geo::Vector > &i_points,
+                   Eureka::ThreadPool              &io_pool,
+                   std::vector< UID >              &o_order );
+
+  void rcmOrder( const Eureka::Graph &i_graph,
+                 std::vector< UID >  &o_order );
+}
+
+//! ----------------------------------------------------------------------------
+//! Undirected graph in compressed rows: neighbours of vertex v are
+//! m_adj[m_offsets[v] .. m_offsets[v + 1]), sorted and unique
+//! ----------------------------------------------------------------------------
+struct Eureka::Graph {
+  std::vector< UID > m_offsets, m_adj;
+
+  //! Build from tets (4 vertex indices < i_num per tet) connecting all corners
+  void build( const UID                &i_num,
+              const std::vector< UID > &i_tets,
+              Eureka::ThreadPool       &io_pool );
+
+  //! Build the dual of tets (4 vertex indices < i_num per tet): tets are the
+  //! vertices, connected if they share a face
+  void buildDual( const UID                &i_num,
+                  const std::vector< UID > &i_tets,
+                  Eureka::ThreadPool       &io_pool );
+
+  UID size() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+  UID degree( const UID &i_v ) const { return m_offsets[i_v + 1] - m_offsets[i_v]; }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,166 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Buffered output functions for EurekaGen.
+ **/
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "EurekaOut.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Write i_size bytes to descriptor at offset (returns false on failure)
+//! ----------------------------------------------------------------------------
+static bool writeAll( const int    &i_fd,
+                      const char   *i_data,
+                      const size_t &i_size,
+                      const size_t &i_off ) {
+  const char *l_pos = i_data;
+  size_t l_left = i_size, l_off = i_off;
+
+  //! pwrite may take less than asked for
+  while( l_left > 0 ) {
+    ssize_t l_num = ::pwrite( i_fd, l_pos, l_left, l_off );
+    if( l_num < 0 && errno == EINTR )
+      continue;
+    if( l_num <= 0 )
+      return false;
+
+    l_pos  += l_num;
+    l_off  += l_num;
+    l_left -= l_num;
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Create or truncate file (returns false on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::OutFile::open( const char *i_filename ) {
+  close();
+
+  m_fd = ::open( i_filename, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+  return (m_fd >= 0);
+}
+
+//! ----------------------------------------------------------------------------
+//! Close file
+//! ----------------------------------------------------------------------------
+void Eureka::OutFile::close() {
+  if( m_fd >= 0 )
+    ::close( m_fd );
+
+  m_fd = -1;
+}
+
+//! ----------------------------------------------------------------------------
+//! Allocate [i_off, i_off + i_len) ahead of writing (only a hint)
+//! ----------------------------------------------------------------------------
+void Eureka::OutFile::reserve( const size_t &i_off,
+                               const size_t &i_len ) const {
+  if( i_len > 0 )
+    posix_fallocate( m_fd, i_off, i_len );
+}
+
+//! ----------------------------------------------------------------------------
+//! Write i_size bytes at offset (returns false on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::OutFile::write( const char   *i_data,
+                             const size_t &i_size,
+                             const size_t &i_off ) const {
+  return writeAll( m_fd, i_data, i_size, i_off );
+}
+
+//! ----------------------------------------------------------------------------
+//! Create in directory (returns false on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::SpillFile::open( const std::string &i_dir ) {
+  close();
+
+  std::string l_name = (i_dir.empty() ? std::string( "." ) : i_dir) + "/EurekaSpill.XXXXXX";
+  std::vector< char > l_template( l_name.begin(), l_name.end() );
+  l_template.push_back( '\0' );
+
+  m_fd = mkstemp( l_template.data() );
+  if( m_fd < 0 )
+    return false;
+
+  //! Gone from the directory, freed when closed
+  unlink( l_template.data() );
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Close (and so delete) file
+//! ----------------------------------------------------------------------------
+void Eureka::SpillFile::close() {
+  if( m_fd >= 0 )
+    ::close( m_fd );
+
+  m_fd    = -1;
+  m_size  = 0;
+  m_lines = 0;
+}
+
+//! ----------------------------------------------------------------------------
+//! Append buffer holding i_lines lines (returns false on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::SpillFile::append( const Eureka::OutBuffer &i_buf,
+                                const UID               &i_lines ) {
+  if( !writeAll( m_fd, i_buf.m_data.data(), i_buf.m_size, m_size ) )
+    return false;
+
+  m_size  += i_buf.m_size;
+  m_lines += i_lines;
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Copy everything appended to output file at offset (returns false on
+//! failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::SpillFile::copyTo( const Eureka::OutFile &i_out,
+                                const size_t          &i_off ) const {
+  std::vector< char > l_buf( std::min( m_size, Eureka::OUTBUFSIZE ) );
+
+  for( size_t l_done = 0; l_done < m_size; ) {
+    ssize_t l_num = ::pread( m_fd, l_buf.data(), std::min( l_buf.size(), m_size - l_done ),
+                             l_done );
+    if( l_num < 0 && errno == EINTR )
+      continue;
+    if( l_num <= 0 || !i_out.write( l_buf.data(), l_num, i_off + l_done ) )
+      return false;
+
+    l_done += l_num;
+  }
+
+  return true;
+}
\ No newline at end of file
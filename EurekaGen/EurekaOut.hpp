@@ -0,0 +1,190 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Buffered output of the .dat file (numbers formatted with to_chars, chunks
+ * written at computed offsets) and temporary spill files.
+ **/
+
+#ifndef EUREKA_OUT_HPP
+#define EUREKA_OUT_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "EurekaConstants.h"
+#include "../GeoGen/GeoConstants.h"
+
+namespace Eureka {
+  //! Lines (nodes, elements or group IDs) per chunk of output
+  const size_t OUTCHUNKLINES = 1 << 15;
+
+  //! Bytes buffered before a sequential writer writes them out
+  const size_t OUTBUFSIZE = 1 << 22;
+
+  //! Room for the longest formatted number
+  const size_t MAXNUMCHARS = 32;
+
+  struct OutBuffer;
+  class OutFile;
+  class SpillFile;
+}
+
+//! ----------------------------------------------------------------------------
+//! Growing character buffer; formats numbers like the default std::ostream
+//! (integers in decimal, reals as printf's %.6g)
+//! ----------------------------------------------------------------------------
+struct Eureka::OutBuffer {
+  std::vector< char > m_data;
+  size_t m_size;
+
+  OutBuffer() : m_size(0) {}
+
+  void clear() { m_size = 0; }
+
+  //! Pointer to at least i_num free bytes at the end
+  char *room( const size_t &i_num ) {
+    if( m_size + i_num > m_data.size() )
+      m_data.resize( std::max( 2 * m_data.size(), m_size + i_num ) );
+
+    return m_data.data() + m_size;
+  }
+
+  OutBuffer & operator << ( const char &i_c ) {
+    *room( 1 ) = i_c;
+    m_size++;
+    return *this;
+  }
+
+  OutBuffer & operator << ( const char *i_str ) {
+    size_t l_len = strlen( i_str );
+    memcpy( room( l_len ), i_str, l_len );
+    m_size += l_len;
+    return *this;
+  }
+
+  OutBuffer & operator << ( const std::string &i_str ) {
+    memcpy( room( i_str.size() ), i_str.data(), i_str.size() );
+    m_size += i_str.size();
+    return *this;
+  }
+
+  OutBuffer & operator << ( const unsigned int &i_val ) {
+    char *l_pos = room( MAXNUMCHARS );
+    m_size = std::to_chars( l_pos, l_pos + MAXNUMCHARS, i_val ).ptr - m_data.data();
+    return *this;
+  }
+
+  OutBuffer & operator << ( const UID &i_val ) {
+    char *l_pos = room( MAXNUMCHARS );
+    m_size = std::to_chars( l_pos, l_pos + MAXNUMCHARS, i_val ).ptr - m_data.data();
+    return *this;
+  }
+
+  OutBuffer & operator << ( const real &i_val ) {
+    char *l_pos = room( MAXNUMCHARS );
+    m_size = std::to_chars( l_pos, l_pos + MAXNUMCHARS, i_val,
+                            std::chars_format::general, 6 ).ptr - m_data.data();
+    return *this;
+  }
+};
+
+//! ----------------------------------------------------------------------------
+//! Output file written with positioned writes (safe from several threads)
+//! ----------------------------------------------------------------------------
+class Eureka::OutFile {
+private:
+  int m_fd;
+
+public:
+  OutFile() : m_fd(-1) {}
+  ~OutFile() { close(); }
+
+  //! Non-copyable as it owns the descriptor
+  OutFile( const OutFile & ) = delete;
+  OutFile & operator = ( const OutFile & ) = delete;
+
+  //! Create or truncate file (returns false on failure)
+  bool open( const char *i_filename );
+  void close();
+
+  //! Allocate [i_off, i_off + i_len) ahead of writing (only a hint)
+  void reserve( const size_t &i_off,
+                const size_t &i_len ) const;
+
+  //! Write i_size bytes at offset (returns false on failure)
+  bool write( const char   *i_data,
+              const size_t &i_size,
+              const size_t &i_off ) const;
+
+  //! Write all of buffer at offset (returns false on failure)
+  bool write( const Eureka::OutBuffer &i_buf,
+              const size_t            &i_off ) const {
+    return write( i_buf.m_data.data(), i_buf.m_size, i_off );
+  }
+};
+
+//! ----------------------------------------------------------------------------
+//! Anonymous temporary file that lines are appended to and later copied into
+//! an output file (removed from the directory as soon as it is created)
+//! ----------------------------------------------------------------------------
+class Eureka::SpillFile {
+private:
+  int m_fd;
+
+  //! Bytes and lines appended so far
+  size_t m_size;
+  UID    m_lines;
+
+public:
+  SpillFile() : m_fd(-1), m_size(0), m_lines(0) {}
+  ~SpillFile() { close(); }
+
+  //! Non-copyable as it owns the descriptor
+  SpillFile( const SpillFile & ) = delete;
+  SpillFile & operator = ( const SpillFile & ) = delete;
+
+  //! Create in directory (returns false on failure)
+  bool open( const std::string &i_dir );
+  void close();
+
+  size_t size()  const { return m_size; }
+  UID    lines() const { return m_lines; }
+
+  //! Append buffer holding i_lines lines (returns false on failure)
+  bool append( const Eureka::OutBuffer &i_buf,
+               const UID               &i_lines );
+
+  //! Copy everything appended to output file at offset (returns false on
+  //! failure)
+  bool copyTo( const Eureka::OutFile &i_out,
+               const size_t          &i_off ) const;
+};
+
+#endif
\ No newline at end of file
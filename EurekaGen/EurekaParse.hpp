@@ -0,0 +1,242 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Allocation-free tokenizer for memory-mapped text (.msh) files.
+ **/
+
+#ifndef EUREKA_PARSE_HPP
+#define EUREKA_PARSE_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+#include "EurekaConstants.h"
+
+namespace Eureka {
+  struct Field;
+
+  //! Most fields we ever need on a line (2.2 tet with up to 9 tags)
+  const int MAXFIELDS = 16;
+
+  inline const char *findEol( const char *i_pos,
+                              const char *i_end );
+
+  inline bool startsWith( const char *i_beg,
+                          const char *i_end,
+                          const char *i_str );
+
+  inline const char *findLine( const char *i_pos,
+                               const char *i_end,
+                               const char *i_str );
+
+  inline bool skipLines( const char *&io_pos,
+                         const char  *i_end,
+                         const UID   &i_num );
+
+  inline bool nextToken( const char    *&io_pos,
+                         const char     *i_end,
+                         Eureka::Field  &o_field );
+
+  inline void splitChunks( const char                  *i_beg,
+                           const char                  *i_end,
+                           const size_t                &i_num,
+                           std::vector< const char * > &o_bounds );
+
+  inline int splitFields( const char   *i_beg,
+                          const char   *i_end,
+                          Eureka::Field (&o_fields)[MAXFIELDS] );
+
+  template< typename T >
+  inline bool toNum( const Eureka::Field &i_field,
+                     T                   &o_val );
+}
+
+//! ----------------------------------------------------------------------------
+//! Field (blank separated token) of a line, pointing into the mapped file
+//! ----------------------------------------------------------------------------
+struct Eureka::Field {
+  const char *m_beg, *m_end;
+
+  Field() : m_beg(nullptr), m_end(nullptr) {}
+
+  bool operator == ( const char *i_str ) const {
+    size_t l_len = strlen( i_str );
+    return (size_t) (m_end - m_beg) == l_len && !memcmp( m_beg, i_str, l_len );
+  }
+};
+
+//! ----------------------------------------------------------------------------
+//! End of line starting at i_pos (points at '\n' or at i_end)
+//! ----------------------------------------------------------------------------
+inline const char *Eureka::findEol( const char *i_pos,
+                                    const char *i_end ) {
+  const char *l_eol = static_cast< const char * >(memchr( i_pos, '\n', i_end - i_pos ));
+  return (l_eol ? l_eol : i_end);
+}
+
+//! ----------------------------------------------------------------------------
+//! Check if line starts with given string
+//! ----------------------------------------------------------------------------
+inline bool Eureka::startsWith( const char *i_beg,
+                                const char *i_end,
+                                const char *i_str ) {
+  size_t l_len = strlen( i_str );
+  return (size_t) (i_end - i_beg) >= l_len && !memcmp( i_beg, i_str, l_len );
+}
+
+//! ----------------------------------------------------------------------------
+//! Start of first line (at or after i_pos) starting with given string, or i_end
+//! ----------------------------------------------------------------------------
+inline const char *Eureka::findLine( const char *i_pos,
+                                     const char *i_end,
+                                     const char *i_str ) {
+  const char *l_pos = i_pos;
+
+  //! Only candidates are the first characters of lines
+  while( l_pos < i_end ) {
+    if( (l_pos == i_pos || *(l_pos - 1) == '\n') && startsWith( l_pos, i_end, i_str ) )
+      return l_pos;
+
+    l_pos = static_cast< const char * >(memchr( l_pos + 1, *i_str, i_end - l_pos - 1 ));
+    if( !l_pos )
+      return i_end;
+  }
+
+  return i_end;
+}
+
+//! ----------------------------------------------------------------------------
+//! Move past i_num lines (returns false if file ends before)
+//! ----------------------------------------------------------------------------
+inline bool Eureka::skipLines( const char *&io_pos,
+                               const char  *i_end,
+                               const UID   &i_num ) {
+  for( UID l_i = 0; l_i < i_num; l_i++ ) {
+    if( io_pos >= i_end )
+      return false;
+
+    io_pos = findEol( io_pos, i_end );
+    if( io_pos < i_end )
+      io_pos++;
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Next blank or newline separated token (returns false at i_end)
+//! ----------------------------------------------------------------------------
+inline bool Eureka::nextToken( const char    *&io_pos,
+                               const char     *i_end,
+                               Eureka::Field  &o_field ) {
+  while( io_pos < i_end && (*io_pos == ' ' || *io_pos == '\t' || *io_pos == '\r' ||
+                            *io_pos == '\n') )
+    io_pos++;
+
+  if( io_pos == i_end )
+    return false;
+
+  o_field.m_beg = io_pos;
+  while( io_pos < i_end && *io_pos != ' ' && *io_pos != '\t' && *io_pos != '\r' &&
+                           *io_pos != '\n' )
+    io_pos++;
+  o_field.m_end = io_pos;
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Split [i_beg, i_end) into at most i_num newline-aligned chunks (chunk c is
+//! [o_bounds[c], o_bounds[c + 1]))
+//! ----------------------------------------------------------------------------
+inline void Eureka::splitChunks( const char                  *i_beg,
+                                 const char                  *i_end,
+                                 const size_t                &i_num,
+                                 std::vector< const char * > &o_bounds ) {
+  o_bounds.assign( 1, i_beg );
+
+  const char *l_pos = i_beg;
+  for( size_t l_c = 0; l_c < i_num && l_pos < i_end; l_c++ ) {
+    const char *l_end = (l_c + 1 == i_num) ? i_end :
+                        std::max( l_pos, i_beg + (l_c + 1) * (i_end - i_beg) / i_num );
+
+    //! Move chunk end past the next newline
+    if( l_end < i_end ) {
+      l_end = findEol( l_end, i_end );
+      l_end = (l_end < i_end) ? l_end + 1 : i_end;
+    }
+
+    o_bounds.push_back( l_end );
+    l_pos = l_end;
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Split line at blanks (returns number of fields, at most MAXFIELDS)
+//! ----------------------------------------------------------------------------
+inline int Eureka::splitFields( const char   *i_beg,
+                                const char   *i_end,
+                                Eureka::Field (&o_fields)[MAXFIELDS] ) {
+  int l_num = 0;
+  const char *l_pos = i_beg;
+
+  while( l_num < MAXFIELDS ) {
+    //! Blanks (and carriage return of DOS line endings)
+    while( l_pos < i_end && (*l_pos == ' ' || *l_pos == '\t' || *l_pos == '\r') )
+      l_pos++;
+
+    if( l_pos == i_end )
+      break;
+
+    o_fields[l_num].m_beg = l_pos;
+    while( l_pos < i_end && *l_pos != ' ' && *l_pos != '\t' && *l_pos != '\r' )
+      l_pos++;
+    o_fields[l_num++].m_end = l_pos;
+  }
+
+  return l_num;
+}
+
+//! ----------------------------------------------------------------------------
+//! Convert whole field to a number (returns false if malformed)
+//! ----------------------------------------------------------------------------
+template< typename T >
+inline bool Eureka::toNum( const Eureka::Field &i_field,
+                           T                   &o_val ) {
+  const char *l_beg = i_field.m_beg;
+
+  //! from_chars does not accept an explicit plus sign
+  if( l_beg < i_field.m_end && *l_beg == '+' )
+    l_beg++;
+
+  std::from_chars_result l_res = std::from_chars( l_beg, i_field.m_end, o_val );
+  return (l_res.ec == std::errc() && l_res.ptr == i_field.m_end);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Mesh partitioning: recursive coordinate bisection and greedy refinement.
+ **/
+
+#include <algorithm>
+#include <cmath>
+
+#include "EurekaPart.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Split points [i_beg, i_end) into parts i_first..i_first+i_num-1: halve
+//! the part count, cut across the longest side of the bounding box so that
+//! the point counts follow
+//! ----------------------------------------------------------------------------
+static void bisect( const std::vector< geo::Vector > &i_points,
+                    std::vector< UID >::iterator      i_beg,
+                    std::vector< UID >::iterator      i_end,
+                    const unsigned int               &i_first,
+                    const unsigned int               &i_num,
+                    std::vector< unsigned int >      &o_part ) {
+  if( i_num == 1 || i_beg == i_end ) {
+    for( std::vector< UID >::iterator l_it = i_beg; l_it != i_end; ++l_it )
+      o_part[*l_it] = i_first;
+    return;
+  }
+
+  //! Bounding box
+  geo::Vector l_min = i_points[*i_beg], l_max = i_points[*i_beg];
+  for( std::vector< UID >::iterator l_it = i_beg; l_it != i_end; ++l_it ) {
+    const geo::Vector &l_P = i_points[*l_it];
+    l_min.m_x = std::min( l_min.m_x, l_P.m_x );
+    l_min.m_y = std::min( l_min.m_y, l_P.m_y );
+    l_min.m_z = std::min( l_min.m_z, l_P.m_z );
+    l_max.m_x = std::max( l_max.m_x, l_P.m_x );
+    l_max.m_y = std::max( l_max.m_y, l_P.m_y );
+    l_max.m_z = std::max( l_max.m_z, l_P.m_z );
+  }
+
+  real l_dx = l_max.m_x - l_min.m_x, l_dy = l_max.m_y - l_min.m_y, l_dz = l_max.m_z - l_min.m_z;
+  real geo::Vector::*l_axis = (l_dx >= l_dy && l_dx >= l_dz) ? &geo::Vector::m_x :
+                              (l_dy >= l_dz)                 ? &geo::Vector::m_y :
+                                                               &geo::Vector::m_z;
+
+  //! Cut where the point counts are proportional to the part counts (ties
+  //! broken by index so that the result does not depend on the sort)
+  unsigned int l_numLeft = i_num / 2;
+  std::vector< UID >::iterator l_mid = i_beg + (i_end - i_beg) * l_numLeft / i_num;
+  std::nth_element( i_beg, l_mid, i_end, [&]( const UID &i_a, const UID &i_b ) {
+    real l_a = i_points[i_a].*l_axis, l_b = i_points[i_b].*l_axis;
+    return (l_a < l_b) || (l_a == l_b && i_a < i_b);
+  } );
+
+  bisect( i_points, i_beg, l_mid, i_first, l_numLeft, o_part );
+  bisect( i_points, l_mid, i_end, i_first + l_numLeft, i_num - l_numLeft, o_part );
+}
+
+//! ----------------------------------------------------------------------------
+//! Recursive coordinate bisection of points into i_numParts parts of (almost)
+//! equal size
+//! ----------------------------------------------------------------------------
+void Eureka::rcbPartition( const std::vector< geo::Vector > &i_points,
+                           const unsigned int               &i_numParts,
+                           std::vector< unsigned int >      &o_part ) {
+  std::vector< UID > l_index( i_points.size() );
+  for( size_t l_i = 0; l_i < l_index.size(); l_i++ )
+    l_index[l_i] = l_i;
+
+  o_part.assign( i_points.size(), 0 );
+  bisect( i_points, l_index.begin(), l_index.end(), 0, std::max( 1u, i_numParts ), o_part );
+}
+
+//! ----------------------------------------------------------------------------
+//! Number of faces between elements of different parts
+//! ----------------------------------------------------------------------------
+UID Eureka::cutFaces( const Eureka::Graph               &i_dual,
+                      const std::vector< unsigned int > &i_part ) {
+  UID l_cut = 0;
+  for( UID l_e = 0; l_e < i_dual.size(); l_e++ )
+    for( UID l_a = i_dual.m_offsets[l_e]; l_a < i_dual.m_offsets[l_e + 1]; l_a++ )
+      if( i_part[l_e] != i_part[i_dual.m_adj[l_a]] )
+        l_cut++;
+
+  return l_cut / 2;
+}
+
+//! ----------------------------------------------------------------------------
+//! Greedy refinement: move elements to the part most of their face
+//! neighbours are in while that cuts fewer faces and keeps parts within
+//! PARTIMBALANCE of the average
+//! ----------------------------------------------------------------------------
+void Eureka::refinePartition( const Eureka::Graph         &i_dual,
+                              const unsigned int          &i_numParts,
+                              std::vector< unsigned int > &io_part ) {
+  UID l_num = i_dual.size();
+  if( i_numParts < 2 || !l_num )
+    return;
+
+  //! Part sizes and their bounds
+  std::vector< UID > l_sizes( i_numParts, 0 );
+  for( UID l_e = 0; l_e < l_num; l_e++ )
+    l_sizes[io_part[l_e]]++;
+
+  real l_avg = (real) l_num / i_numParts;
+  UID  l_max = (UID) std::ceil( l_avg * Eureka::PARTIMBALANCE );
+  UID  l_min = (UID) std::max( 1.0, std::floor( l_avg * (2.0 - Eureka::PARTIMBALANCE) ) );
+
+  for( int l_pass = 0; l_pass < Eureka::PARTPASSES; l_pass++ ) {
+    UID l_moved = 0;
+
+    for( UID l_e = 0; l_e < l_num; l_e++ ) {
+      unsigned int l_from = io_part[l_e];
+
+      //! Neighbours per part (4 face neighbours of a tet; further ones, only
+      //! possible in a non-conforming mesh, are not tracked)
+      unsigned int l_parts[4];
+      int l_counts[4], l_numParts = 0, l_own = 0;
+      for( UID l_a = i_dual.m_offsets[l_e]; l_a < i_dual.m_offsets[l_e + 1]; l_a++ ) {
+        unsigned int l_p = io_part[i_dual.m_adj[l_a]];
+        if( l_p == l_from ) {
+          l_own++;
+          continue;
+        }
+
+        int l_i = 0;
+        while( l_i < l_numParts && l_parts[l_i] != l_p )
+          l_i++;
+        if( l_i == l_numParts ) {
+          if( l_numParts == 4 )
+            continue;
+          l_parts[l_numParts]   = l_p;
+          l_counts[l_numParts++] = 0;
+        }
+        l_counts[l_i]++;
+      }
+
+      //! Best other part (fewest elements on ties)
+      int l_best = -1;
+      for( int l_i = 0; l_i < l_numParts; l_i++ )
+        if( l_best < 0 || l_counts[l_i] > l_counts[l_best] ||
+            (l_counts[l_i] == l_counts[l_best] &&
+             l_sizes[l_parts[l_i]] < l_sizes[l_parts[l_best]]) )
+          l_best = l_i;
+
+      if( l_best < 0 || l_counts[l_best] <= l_own ||
+          l_sizes[l_parts[l_best]] + 1 > l_max || l_sizes[l_from] - 1 < l_min )
+        continue;
+
+      io_part[l_e] = l_parts[l_best];
+      l_sizes[l_from]--;
+      l_sizes[l_parts[l_best]]++;
+      l_moved++;
+    }
+
+    if( !l_moved )
+      break;
+  }
+}
\ No newline at end of file
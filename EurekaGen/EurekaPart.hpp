@@ -0,0 +1,59 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Mesh partitioning: recursive coordinate bisection and greedy refinement.
+ **/
+
+#ifndef EUREKA_PART_HPP
+#define EUREKA_PART_HPP
+
+#include <vector>
+
+#include "EurekaConstants.h"
+#include "EurekaOrder.hpp"
+#include "../GeoGen/Geo.hpp"
+
+namespace Eureka {
+  //! Largest part refinement may grow to, relative to the average part
+  const real PARTIMBALANCE = 1.03;
+
+  //! Most refinement passes over the elements
+  const int PARTPASSES = 8;
+
+  void rcbPartition( const std::vector< geo::Vector > &i_points,
+                     const unsigned int               &i_numParts,
+                     std::vector< unsigned int >      &o_part );
+
+  UID cutFaces( const Eureka::Graph               &i_dual,
+                const std::vector< unsigned int > &i_part );
+
+  void refinePartition( const Eureka::Graph         &i_dual,
+                        const unsigned int          &i_numParts,
+                        std::vector< unsigned int > &io_part );
+}
+
+#endif
\ No newline at end of file
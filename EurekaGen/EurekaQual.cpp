@@ -0,0 +1,255 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Closed-form tetrahedron quality metrics, evaluated in batches.
+ **/
+
+#include <algorithm>
+#include <cmath>
+
+#include "EurekaQual.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Select metric by name (returns false if unknown)
+//! ----------------------------------------------------------------------------
+bool Eureka::TetQuality::setMetric( const std::string &i_name ) {
+  if( i_name == "legacy" )
+    m_metric = Eureka::QualMetric::LEGACY;
+  else if( i_name == "radius_ratio" )
+    m_metric = Eureka::QualMetric::RADIUS_RATIO;
+  else if( i_name == "aspect_ratio" )
+    m_metric = Eureka::QualMetric::ASPECT_RATIO;
+  else if( i_name == "edge_ratio" )
+    m_metric = Eureka::QualMetric::EDGE_RATIO;
+  else if( i_name == "min_dihedral" )
+    m_metric = Eureka::QualMetric::MIN_DIHEDRAL;
+  else
+    return false;
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Name of selected metric
+//! ----------------------------------------------------------------------------
+const char *Eureka::TetQuality::name() const {
+  switch( m_metric ) {
+    case Eureka::QualMetric::RADIUS_RATIO:
+      return "radius_ratio";
+    case Eureka::QualMetric::ASPECT_RATIO:
+      return "aspect_ratio";
+    case Eureka::QualMetric::EDGE_RATIO:
+      return "edge_ratio";
+    case Eureka::QualMetric::MIN_DIHEDRAL:
+      return "min_dihedral";
+    default:
+      return "legacy";
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Threshold of selected metric
+//! ----------------------------------------------------------------------------
+real Eureka::TetQuality::threshold() const {
+  if( m_threshold > 0.0 )
+    return m_threshold;
+
+  switch( m_metric ) {
+    case Eureka::QualMetric::RADIUS_RATIO:
+    case Eureka::QualMetric::ASPECT_RATIO:
+      return 3.0;
+    case Eureka::QualMetric::EDGE_RATIO:
+      return 5.0;
+    case Eureka::QualMetric::MIN_DIHEDRAL:
+      return 10.0;
+    default:
+      return 6.0;
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Metric and bad flag of every tet of the batch
+//! ----------------------------------------------------------------------------
+void Eureka::TetQuality::eval( const Eureka::TetBatch &i_batch,
+                               real                   (&o_qual)[QUALBATCH],
+                               bool                   (&o_bad)[QUALBATCH] ) const {
+  const real (&l_x)[4][QUALBATCH] = i_batch.m_x;
+  const real (&l_y)[4][QUALBATCH] = i_batch.m_y;
+  const real (&l_z)[4][QUALBATCH] = i_batch.m_z;
+
+  //! Radius ratio, edge ratio, longest edge over inradius, and doubled area
+  //! vectors (x, y, z, length) of faces BCD, ACD, ABD and ABC
+  real l_rRatio[QUALBATCH], l_eRatio[QUALBATCH], l_aRatio[QUALBATCH];
+  real l_face[4][4][QUALBATCH];
+
+  //! Straight-line arithmetic on the lanes (sqrt maps to sqrtpd, as the
+  //! Makefile drops errno from math calls)
+#pragma omp simd
+  for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ ) {
+    //! Edges a = AB, b = AC, c = AD
+    real l_ax = l_x[1][l_j] - l_x[0][l_j];
+    real l_ay = l_y[1][l_j] - l_y[0][l_j];
+    real l_az = l_z[1][l_j] - l_z[0][l_j];
+    real l_bx = l_x[2][l_j] - l_x[0][l_j];
+    real l_by = l_y[2][l_j] - l_y[0][l_j];
+    real l_bz = l_z[2][l_j] - l_z[0][l_j];
+    real l_cx = l_x[3][l_j] - l_x[0][l_j];
+    real l_cy = l_y[3][l_j] - l_y[0][l_j];
+    real l_cz = l_z[3][l_j] - l_z[0][l_j];
+
+    //! Doubled area vectors of faces ACD (b x c), ABD (c x a) and ABC (a x b)
+    real l_bcx = l_by * l_cz - l_bz * l_cy;
+    real l_bcy = l_bz * l_cx - l_bx * l_cz;
+    real l_bcz = l_bx * l_cy - l_by * l_cx;
+    real l_cax = l_cy * l_az - l_cz * l_ay;
+    real l_cay = l_cz * l_ax - l_cx * l_az;
+    real l_caz = l_cx * l_ay - l_cy * l_ax;
+    real l_abx = l_ay * l_bz - l_az * l_by;
+    real l_aby = l_az * l_bx - l_ax * l_bz;
+    real l_abz = l_ax * l_by - l_ay * l_bx;
+
+    //! ... and of face BCD (all four sum to zero)
+    real l_nx = l_bcx + l_cax + l_abx;
+    real l_ny = l_bcy + l_cay + l_aby;
+    real l_nz = l_bcz + l_caz + l_abz;
+
+    //! Six times the volume
+    real l_det = std::abs( l_ax * l_bcx + l_ay * l_bcy + l_az * l_bcz );
+
+    //! Squared edge lengths
+    real l_a2 = l_ax * l_ax + l_ay * l_ay + l_az * l_az;
+    real l_b2 = l_bx * l_bx + l_by * l_by + l_bz * l_bz;
+    real l_c2 = l_cx * l_cx + l_cy * l_cy + l_cz * l_cz;
+    real l_d2 = (l_bx - l_ax) * (l_bx - l_ax) + (l_by - l_ay) * (l_by - l_ay) +
+                (l_bz - l_az) * (l_bz - l_az);
+    real l_e2 = (l_cx - l_ax) * (l_cx - l_ax) + (l_cy - l_ay) * (l_cy - l_ay) +
+                (l_cz - l_az) * (l_cz - l_az);
+    real l_f2 = (l_cx - l_bx) * (l_cx - l_bx) + (l_cy - l_by) * (l_cy - l_by) +
+                (l_cz - l_bz) * (l_cz - l_bz);
+
+    real l_min2 = std::min( std::min( l_a2, l_b2 ),
+                            std::min( std::min( l_c2, l_d2 ), std::min( l_e2, l_f2 ) ) );
+    real l_max2 = std::max( std::max( l_a2, l_b2 ),
+                            std::max( std::max( l_c2, l_d2 ), std::max( l_e2, l_f2 ) ) );
+
+    //! Doubled face areas; inradius is det / (sum of doubled areas)
+    real l_sN  = std::sqrt( l_nx  * l_nx  + l_ny  * l_ny  + l_nz  * l_nz );
+    real l_sBC = std::sqrt( l_bcx * l_bcx + l_bcy * l_bcy + l_bcz * l_bcz );
+    real l_sCA = std::sqrt( l_cax * l_cax + l_cay * l_cay + l_caz * l_caz );
+    real l_sAB = std::sqrt( l_abx * l_abx + l_aby * l_aby + l_abz * l_abz );
+    real l_area = l_sN + l_sBC + l_sCA + l_sAB;
+
+    //! Circumcenter (relative to A) times 2 det, so circumradius is
+    //! |o| / (2 det)
+    real l_ox = l_a2 * l_bcx + l_b2 * l_cax + l_c2 * l_abx;
+    real l_oy = l_a2 * l_bcy + l_b2 * l_cay + l_c2 * l_aby;
+    real l_oz = l_a2 * l_bcz + l_b2 * l_caz + l_c2 * l_abz;
+
+    l_rRatio[l_j] = std::sqrt( l_ox * l_ox + l_oy * l_oy + l_oz * l_oz ) * l_area /
+                    (2.0 * l_det * l_det);
+    l_eRatio[l_j] = std::sqrt( l_max2 / l_min2 );
+    l_aRatio[l_j] = std::sqrt( l_max2 ) * l_area / l_det;
+
+    l_face[0][0][l_j] = l_nx;  l_face[0][1][l_j] = l_ny;
+    l_face[0][2][l_j] = l_nz;  l_face[0][3][l_j] = l_sN;
+    l_face[1][0][l_j] = l_bcx; l_face[1][1][l_j] = l_bcy;
+    l_face[1][2][l_j] = l_bcz; l_face[1][3][l_j] = l_sBC;
+    l_face[2][0][l_j] = l_cax; l_face[2][1][l_j] = l_cay;
+    l_face[2][2][l_j] = l_caz; l_face[2][3][l_j] = l_sCA;
+    l_face[3][0][l_j] = l_abx; l_face[3][1][l_j] = l_aby;
+    l_face[3][2][l_j] = l_abz; l_face[3][3][l_j] = l_sAB;
+  }
+
+  //! One pass per metric keeps the switch out of the lanes
+  switch( m_metric ) {
+    case Eureka::QualMetric::RADIUS_RATIO:
+#pragma omp simd
+      for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ )
+        o_qual[l_j] = l_rRatio[l_j] / 3.0;
+      break;
+    case Eureka::QualMetric::ASPECT_RATIO:
+#pragma omp simd
+      for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ )
+        o_qual[l_j] = l_aRatio[l_j] / (2.0 * std::sqrt( 6.0 ));
+      break;
+    case Eureka::QualMetric::EDGE_RATIO:
+      std::copy( l_eRatio, l_eRatio + Eureka::QUALBATCH, o_qual );
+      break;
+    case Eureka::QualMetric::MIN_DIHEDRAL: {
+      //! Dihedral angle between faces i, j has cosine -n_i.n_j / (|n_i| |n_j|)
+      //! (face BCD has normal n, the others -(b x c), -(c x a), -(a x b))
+      const real (&l_n)[4][QUALBATCH]  = l_face[0];
+      const real (&l_bc)[4][QUALBATCH] = l_face[1];
+      const real (&l_ca)[4][QUALBATCH] = l_face[2];
+      const real (&l_ab)[4][QUALBATCH] = l_face[3];
+      real l_cosMax[QUALBATCH];
+
+#pragma omp simd
+      for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ ) {
+        real l_cos[6] = {
+          ( l_n[0][l_j]  * l_bc[0][l_j] + l_n[1][l_j]  * l_bc[1][l_j] +
+            l_n[2][l_j]  * l_bc[2][l_j]) / (l_n[3][l_j]  * l_bc[3][l_j]),
+          ( l_n[0][l_j]  * l_ca[0][l_j] + l_n[1][l_j]  * l_ca[1][l_j] +
+            l_n[2][l_j]  * l_ca[2][l_j]) / (l_n[3][l_j]  * l_ca[3][l_j]),
+          ( l_n[0][l_j]  * l_ab[0][l_j] + l_n[1][l_j]  * l_ab[1][l_j] +
+            l_n[2][l_j]  * l_ab[2][l_j]) / (l_n[3][l_j]  * l_ab[3][l_j]),
+          -(l_bc[0][l_j] * l_ca[0][l_j] + l_bc[1][l_j] * l_ca[1][l_j] +
+            l_bc[2][l_j] * l_ca[2][l_j]) / (l_bc[3][l_j] * l_ca[3][l_j]),
+          -(l_bc[0][l_j] * l_ab[0][l_j] + l_bc[1][l_j] * l_ab[1][l_j] +
+            l_bc[2][l_j] * l_ab[2][l_j]) / (l_bc[3][l_j] * l_ab[3][l_j]),
+          -(l_ca[0][l_j] * l_ab[0][l_j] + l_ca[1][l_j] * l_ab[1][l_j] +
+            l_ca[2][l_j] * l_ab[2][l_j]) / (l_ca[3][l_j] * l_ab[3][l_j]) };
+
+        l_cosMax[l_j] = -1.0;
+        for( int l_k = 0; l_k < 6; l_k++ )
+          l_cosMax[l_j] = std::max( l_cosMax[l_j], l_cos[l_k] );
+      }
+
+      //! acos has no vector form short of -ffast-math (libmvec), which would
+      //! change the reported angles, so this pass stays scalar
+      for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ )
+        o_qual[l_j] = std::acos( std::min( l_cosMax[l_j], 1.0 ) ) * 180.0 / M_PI;
+      break;
+    }
+    default:
+      std::copy( l_rRatio, l_rRatio + Eureka::QUALBATCH, o_qual );
+      break;
+  }
+
+  //! Bad flags, scalar (bool lanes do not pack alongside doubles). Degenerate
+  //! tets give NaN or infinity; NaN compares false, hence the negated
+  //! comparisons
+  real l_thr = threshold();
+  for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ ) {
+    if( m_metric == Eureka::QualMetric::MIN_DIHEDRAL )
+      o_bad[l_j] = !(o_qual[l_j] >= l_thr);
+    else if( m_metric == Eureka::QualMetric::LEGACY )
+      o_bad[l_j] = !(l_rRatio[l_j] <= l_thr) && !(l_eRatio[l_j] <= 5.0);
+    else
+      o_bad[l_j] = !(o_qual[l_j] <= l_thr);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Closed-form tetrahedron quality metrics, evaluated in batches.
+ **/
+
+#ifndef EUREKA_QUAL_HPP
+#define EUREKA_QUAL_HPP
+
+#include <string>
+
+#include "EurekaConstants.h"
+#include "../GeoGen/GeoConstants.h"
+
+namespace Eureka {
+  //! Tet quality metrics
+  enum class QualMetric : unsigned char {
+    LEGACY,        //! Circum- to inradius ratio (bad if above 6 and edge ratio above 5)
+    RADIUS_RATIO,  //! Circumradius / (3 inradius), 1 for a regular tet
+    ASPECT_RATIO,  //! Longest edge / (2 sqrt(6) inradius), 1 for a regular tet
+    EDGE_RATIO,    //! Longest / shortest edge
+    MIN_DIHEDRAL   //! Smallest dihedral angle in degrees, 70.53 for a regular tet
+  };
+
+  //! Tets evaluated at once
+  const int QUALBATCH = 4;
+
+  //! Most histogram bins
+  const long QUALMAXBINS = 1000;
+
+  struct TetBatch;
+
+  class TetQuality;
+}
+
+//! ----------------------------------------------------------------------------
+//! Corners (x, y, z of corner k of tet j at [k][j]) of a batch of tets
+//! ----------------------------------------------------------------------------
+struct Eureka::TetBatch {
+  real m_x[4][QUALBATCH], m_y[4][QUALBATCH], m_z[4][QUALBATCH];
+};
+
+//! ----------------------------------------------------------------------------
+//! Selected quality metric and the threshold beyond which a tet is bad
+//! ----------------------------------------------------------------------------
+class Eureka::TetQuality {
+private:
+  Eureka::QualMetric m_metric;
+
+  //! Threshold (0: default of metric)
+  real m_threshold;
+
+public:
+  TetQuality() : m_metric(Eureka::QualMetric::LEGACY), m_threshold(0.0) {}
+
+  //! Select metric by name (returns false if unknown)
+  bool setMetric( const std::string &i_name );
+
+  void setThreshold( const real &i_threshold ) { m_threshold = i_threshold; }
+
+  const char *name() const;
+  real threshold() const;
+
+  //! Metric and bad flag of every tet of the batch
+  void eval( const Eureka::TetBatch &i_batch,
+             real                   (&o_qual)[QUALBATCH],
+             bool                   (&o_bad)[QUALBATCH] ) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Reader functions of binary Eureka meshes.
+ **/
+
+#include <algorithm>
+#include <cstring>
+
+#include "EurekaOut.hpp"
+#include "EurekaReader.hpp"
+
+//! ----------------------------------------------------------------------------
+//! 8-byte values per entry of section kind (0: unknown kind)
+//! ----------------------------------------------------------------------------
+static uint32_t kindWidth( const uint32_t &i_kind ) {
+  switch( i_kind ) {
+    case Eureka::BIN_NODE_IDS:
+    case Eureka::BIN_NODAL_GROUP:
+    case Eureka::BIN_ELEM_GROUP:
+      return 1;
+    case Eureka::BIN_NODE_COORDS:
+      return 3;
+    case Eureka::BIN_ELEMS:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Map and validate file (returns false with reason on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::BinReader::open( const char  *i_filename,
+                              std::string &o_error ) {
+  close();
+
+  if( !m_file.open( i_filename ) ) {
+    o_error = "Couldn't open " + std::string( i_filename );
+    return false;
+  }
+
+  const Eureka::BinHeader *l_header =
+                     reinterpret_cast< const Eureka::BinHeader * >(m_file.m_data);
+  size_t l_size = m_file.m_size;
+
+  //! Header
+  if( l_size < sizeof( Eureka::BinHeader ) ||
+      !std::equal( Eureka::BIN_MAGIC, Eureka::BIN_MAGIC + 8, l_header->m_magic ) )
+    o_error = std::string( i_filename ) + " is not a binary Eureka mesh";
+  else if( l_header->m_endian != Eureka::BIN_ENDIAN )
+    o_error = std::string( i_filename ) + " was written with different byte order";
+  else if( l_header->m_version != Eureka::BIN_VERSION )
+    o_error = "Unsupported binary mesh version (" +
+              std::to_string( l_header->m_version ) + ")";
+  else if( l_header->m_fileSize != l_size )
+    o_error = std::string( i_filename ) + " is truncated";
+  else if( l_header->m_numSections > (l_size - sizeof( Eureka::BinHeader )) /
+                                     sizeof( Eureka::BinSection ) )
+    o_error = "Section index of " + std::string( i_filename ) + " is truncated";
+
+  if( !o_error.empty() ) {
+    close();
+    return false;
+  }
+
+  //! Sections must lie within the file
+  const Eureka::BinSection *l_sections =
+          reinterpret_cast< const Eureka::BinSection * >(l_header + 1);
+  for( uint64_t l_s = 0; l_s < l_header->m_numSections; l_s++ ) {
+    const Eureka::BinSection &l_sec = l_sections[l_s];
+    uint32_t l_width = kindWidth( l_sec.m_kind );
+
+    if( !memchr( l_sec.m_name, '\0', Eureka::BIN_NAMELEN ) || !l_width ||
+        l_sec.m_width != l_width || l_sec.m_offset % 8 != 0 || l_sec.m_offset > l_size ||
+        l_sec.m_count > (l_size - l_sec.m_offset) / (8 * l_width) ) {
+      o_error = "Malformed section " + std::to_string( l_s ) + " in " +
+                std::string( i_filename );
+      close();
+      return false;
+    }
+  }
+
+  m_header   = l_header;
+  m_sections = l_sections;
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Unmap file
+//! ----------------------------------------------------------------------------
+void Eureka::BinReader::close() {
+  m_file.close();
+  m_header   = nullptr;
+  m_sections = nullptr;
+}
+
+//! ----------------------------------------------------------------------------
+//! First section of kind (and name, if given); nullptr if missing
+//! ----------------------------------------------------------------------------
+const Eureka::BinSection *Eureka::BinReader::find( const uint32_t &i_kind,
+                                                   const char     *i_name ) const {
+  for( size_t l_s = 0; l_s < numSections(); l_s++ )
+    if( m_sections[l_s].m_kind == i_kind &&
+        (i_name == nullptr || !strcmp( m_sections[l_s].m_name, i_name )) )
+      return &m_sections[l_s];
+
+  return nullptr;
+}
+
+//! ----------------------------------------------------------------------------
+//! Write mesh as ASCII .dat file (returns false with reason on failure)
+//! ----------------------------------------------------------------------------
+bool Eureka::BinReader::writeDat( const char  *i_filename,
+                                  std::string &o_error ) const {
+  const Eureka::BinSection *l_ids    = find( Eureka::BIN_NODE_IDS );
+  const Eureka::BinSection *l_coords = find( Eureka::BIN_NODE_COORDS );
+  const Eureka::BinSection *l_elems  = find( Eureka::BIN_ELEMS );
+
+  if( !l_ids || !l_coords || !l_elems || l_ids->m_count != l_coords->m_count ) {
+    o_error = "Binary mesh lacks nodes or elements";
+    return false;
+  }
+
+  Eureka::OutFile l_out;
+  if( !l_out.open( i_filename ) ) {
+    o_error = "Couldn't open " + std::string( i_filename );
+    return false;
+  }
+
+  Eureka::OutBuffer l_buf;
+  size_t l_offset = 0;
+  bool l_ok = true;
+
+  //! Write out buffer once it is large (or if forced)
+  auto l_flush = [&]( bool i_force ) {
+    if( l_ok && (i_force || l_buf.m_size >= Eureka::OUTBUFSIZE) ) {
+      l_ok = l_out.write( l_buf, l_offset );
+      l_offset += l_buf.m_size;
+      l_buf.clear();
+    }
+  };
+
+  l_buf << "3 4 " << (UID) l_ids->m_count << ' ' << (UID) l_elems->m_count << '\n';
+
+  //! Nodes
+  const uint64_t *l_id  = data< uint64_t >( *l_ids );
+  const double   *l_xyz = data< double >( *l_coords );
+  for( uint64_t l_n = 0; l_n < l_ids->m_count; l_n++ ) {
+    l_buf << (UID) l_id[l_n] << ' ' << l_xyz[3 * l_n] << ' ' << l_xyz[3 * l_n + 1] << ' '
+          << l_xyz[3 * l_n + 2] << '\n';
+    l_flush( false );
+  }
+
+  //! Elements
+  const uint64_t *l_nodes = data< uint64_t >( *l_elems );
+  for( uint64_t l_e = 0; l_e < l_elems->m_count; l_e++ ) {
+    l_buf << (UID) (l_e + 1) << ' '
+          << (UID) l_nodes[4 * l_e]     << ' ' << (UID) l_nodes[4 * l_e + 1] << ' '
+          << (UID) l_nodes[4 * l_e + 2] << ' ' << (UID) l_nodes[4 * l_e + 3] << '\n';
+    l_flush( false );
+  }
+
+  //! Nodal and element groups in file order
+  for( size_t l_s = 0; l_s < numSections(); l_s++ ) {
+    const Eureka::BinSection &l_sec = m_sections[l_s];
+    if( l_sec.m_kind != Eureka::BIN_NODAL_GROUP && l_sec.m_kind != Eureka::BIN_ELEM_GROUP )
+      continue;
+
+    l_buf << (UID) l_sec.m_kind << ' ' << l_sec.m_name << ' ' << (UID) l_sec.m_count
+          << '\n';
+
+    const uint64_t *l_list = data< uint64_t >( l_sec );
+    for( uint64_t l_i = 0; l_i < l_sec.m_count; l_i++ ) {
+      l_buf << (UID) l_list[l_i] << '\n';
+      l_flush( false );
+    }
+  }
+
+  l_flush( true );
+
+  if( !l_ok )
+    o_error = "Couldn't write to " + std::string( i_filename );
+
+  return l_ok;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Reader of binary Eureka meshes (.ebm, see EurekaBinary.h).
+ **/
+
+#ifndef EUREKA_READER_HPP
+#define EUREKA_READER_HPP
+
+#include <string>
+
+#include "EurekaBinary.h"
+#include "EurekaMmap.hpp"
+
+namespace Eureka {
+  class BinReader;
+}
+
+//! ----------------------------------------------------------------------------
+//! Memory-mapped binary mesh; sections are used in place
+//! ----------------------------------------------------------------------------
+class Eureka::BinReader {
+private:
+  Eureka::MappedFile        m_file;
+  const Eureka::BinHeader  *m_header;
+  const Eureka::BinSection *m_sections;
+
+public:
+  BinReader() : m_header(nullptr), m_sections(nullptr) {}
+
+  //! Map and validate file (returns false with reason on failure)
+  bool open( const char  *i_filename,
+             std::string &o_error );
+  void close();
+
+  size_t numSections() const { return m_header ? m_header->m_numSections : 0; }
+
+  const Eureka::BinSection &section( const size_t &i_s ) const { return m_sections[i_s]; }
+
+  //! First section of kind (and name, if given); nullptr if missing
+  const Eureka::BinSection *find( const uint32_t &i_kind,
+                                  const char     *i_name = nullptr ) const;
+
+  //! Values of section
+  template< typename T >
+  const T *data( const Eureka::BinSection &i_sec ) const {
+    return reinterpret_cast< const T * >(m_file.m_data + i_sec.m_offset);
+  }
+
+  //! Write mesh as ASCII .dat file (returns false with reason on failure)
+  bool writeDat( const char  *i_filename,
+                 std::string &o_error ) const;
+};
+
+#endif
\ No newline at end of file
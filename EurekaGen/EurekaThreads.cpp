@@ -0,0 +1,122 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Thread pool functions for EurekaGen.
+ **/
+
+#include "EurekaThreads.hpp"
+
+//! ----------------------------------------------------------------------------
+//! Constructor (starts the background workers)
+//! ----------------------------------------------------------------------------
+Eureka::ThreadPool::ThreadPool( unsigned int i_numThreads ) : m_job(nullptr),
+                                                               m_numTasks(0),
+                                                               m_next(0),
+                                                               m_busy(0),
+                                                               m_batch(0),
+                                                               m_stop(false) {
+  if( !i_numThreads )
+    i_numThreads = std::thread::hardware_concurrency();
+  if( !i_numThreads )
+    i_numThreads = 1;
+
+  for( unsigned int l_i = 1; l_i < i_numThreads; l_i++ )
+    m_workers.push_back( std::thread( &Eureka::ThreadPool::loop, this, l_i ) );
+}
+
+//! ----------------------------------------------------------------------------
+//! Destructor (stops and joins the background workers)
+//! ----------------------------------------------------------------------------
+Eureka::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    m_stop = true;
+  }
+  m_wake.notify_all();
+
+  for( size_t l_i = 0; l_i < m_workers.size(); l_i++ )
+    m_workers[l_i].join();
+}
+
+//! ----------------------------------------------------------------------------
+//! Pull tasks of the current batch until none are left
+//! ----------------------------------------------------------------------------
+void Eureka::ThreadPool::work( unsigned int i_worker ) {
+  size_t l_task;
+  while( (l_task = m_next++) < m_numTasks )
+    (*m_job)( l_task, i_worker );
+}
+
+//! ----------------------------------------------------------------------------
+//! Background worker: wait for a batch, work on it, report back
+//! ----------------------------------------------------------------------------
+void Eureka::ThreadPool::loop( unsigned int i_worker ) {
+  unsigned long l_seen = 0;
+
+  while( true ) {
+    {
+      std::unique_lock< std::mutex > l_lock( m_mutex );
+      m_wake.wait( l_lock, [&]() { return m_stop || m_batch != l_seen; } );
+      if( m_stop )
+        return;
+      l_seen = m_batch;
+    }
+
+    work( i_worker );
+
+    {
+      std::lock_guard< std::mutex > l_lock( m_mutex );
+      if( --m_busy == 0 )
+        m_done.notify_one();
+    }
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Run a batch of tasks on all workers (including the caller)
+//! ----------------------------------------------------------------------------
+void Eureka::ThreadPool::run( const size_t                   &i_numTasks,
+                              const Eureka::ThreadPool::Job  &i_job ) {
+  if( !i_numTasks )
+    return;
+
+  {
+    std::lock_guard< std::mutex > l_lock( m_mutex );
+    m_job      = &i_job;
+    m_numTasks = i_numTasks;
+    m_next     = 0;
+    m_busy     = m_workers.size();
+    m_batch++;
+  }
+  m_wake.notify_all();
+
+  work( 0 );
+
+  std::unique_lock< std::mutex > l_lock( m_mutex );
+  m_done.wait( l_lock, [&]() { return m_busy == 0; } );
+  m_job = nullptr;
+}
\ No newline at end of file
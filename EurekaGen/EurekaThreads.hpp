@@ -0,0 +1,87 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Fixed-size thread pool for EurekaGen.
+ **/
+
+#ifndef EUREKA_THREADS_HPP
+#define EUREKA_THREADS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Eureka {
+  class ThreadPool;
+}
+
+//! ----------------------------------------------------------------------------
+//! Thread pool running batches of independent tasks (the calling thread works
+//! as worker 0, so a pool of size 1 runs everything inline)
+//! ----------------------------------------------------------------------------
+class Eureka::ThreadPool {
+public:
+  //! Task callback: task index and worker index (< size())
+  typedef std::function< void( size_t, unsigned int ) > Job;
+
+private:
+  std::vector< std::thread > m_workers;
+
+  std::mutex              m_mutex;
+  std::condition_variable m_wake, m_done;
+
+  //! Current batch
+  const Job             *m_job;
+  size_t                 m_numTasks;
+  std::atomic< size_t >  m_next;
+  unsigned int           m_busy;
+  unsigned long          m_batch;
+  bool                   m_stop;
+
+  void work( unsigned int i_worker );
+  void loop( unsigned int i_worker );
+
+public:
+  //! i_numThreads = 0 uses all hardware threads
+  explicit ThreadPool( unsigned int i_numThreads = 0 );
+  ~ThreadPool();
+
+  ThreadPool( const ThreadPool & ) = delete;
+  ThreadPool & operator = ( const ThreadPool & ) = delete;
+
+  unsigned int size() const { return m_workers.size() + 1; }
+
+  //! Run tasks 0..i_numTasks-1 and wait for all of them
+  void run( const size_t &i_numTasks,
+            const Job    &i_job );
+};
+
+#endif
\ No newline at end of file
@@ -28,27 +28,45 @@
  * Writer functions for EurekaGen.
  **/
 
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <tuple>
 
 #include "EurekaWriter.hpp"
 
 //! ----------------------------------------------------------------------------
 //! Constructor
 //! ----------------------------------------------------------------------------
-Eureka::Writer::Writer( const char *i_inFile,
-                        const char *i_outFile ) : m_time(clock()),
-                                                  m_elemID(1),
-                                                  m_badElems(0) {
-  //! Open .msh file
-  m_inMsh.open( i_inFile, std::ifstream::in );
-  if( !m_inMsh.is_open() ) {
-    std::cerr << "Couldn't open " << i_inFile << "! Exiting..\n";
-    exit( EXIT_FAILURE );
-  }
-
+Eureka::WriterBase::WriterBase( const Eureka::MappedFile &i_msh,
+                                const UID                &i_numElems,
+                                const char               *i_outFile,
+                                const char               *i_matFile ) : m_time(clock()),
+                                                          m_elemID(1),
+                                                          m_gridBuilt(false),
+                                                          m_labelRes(Eureka::LABELAUTO),
+                                                          m_numElems(i_numElems),
+                                                          m_qualBins(0),
+                                                          m_badGroup(false),
+                                                          m_nodeTol(0.0),
+                                                          m_nodeOrder(Eureka::Ordering::NONE),
+                                                          m_elemOrder(Eureka::Ordering::NONE),
+                                                          m_numParts(0),
+                                                          m_partRefine(false),
+                                                          m_stream(false),
+                                                          m_msh(i_msh),
+                                                          m_mshPos(i_msh.m_data),
+                                                          m_mshFormat(Eureka::MshFormat::V22_ASCII),
+                                                          m_outFile(i_outFile),
+                                                          m_matFile(i_matFile) {
   //! Open .dat file
-  m_out.open( i_outFile, std::ofstream::out );
-  if( !m_out.is_open() ) {
+  if( !m_out.open( i_outFile ) ) {
     std::cerr << "Couldn't open " << i_outFile << "! Exiting..\n";
     exit( EXIT_FAILURE );
   }
@@ -57,10 +75,9 @@ Eureka::Writer::Writer( const char *i_inFile,
 //! ----------------------------------------------------------------------------
 //! Destructor
 //! ----------------------------------------------------------------------------
-Eureka::Writer::~Writer() {
+Eureka::WriterBase::~WriterBase() {
   //! Close files
-  m_inMsh.close();
-  m_inMat.close();
+  m_mat.close();
   m_out.close();
 
   //! Delete materials
@@ -74,471 +91,1028 @@ Eureka::Writer::~Writer() {
 }
 
 //! ----------------------------------------------------------------------------
-//! Check element quality
+//! Fill table from parsed node blocks (later duplicates of an ID win);
+//! returns false, leaving the table empty, if node IDs exceed the index type
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::checkElemQual( const geo::Vector &i_A,
-                                    const geo::Vector &i_B,
-                                    const geo::Vector &i_C,
-                                    const geo::Vector &i_D ) {
-  //! Get inradius and circumradius for tet
-  real l_iRad = geo::getInRadius( i_A, i_B, i_C, i_D );
-  real l_cRad = geo::getCircumRadius( i_A, i_B, i_C, i_D );
+template< typename I, typename R >
+bool Eureka::NodeTable< I, R >::build( const std::vector< Eureka::MshBlock > &i_blocks ) {
+  size_t l_num = 0;
+  UID l_maxID = 0;
+
+  std::vector< Eureka::MshBlock >::const_iterator l_it;
+  for( l_it = i_blocks.begin(); l_it != i_blocks.end(); ++l_it ) {
+    l_num += l_it->m_ids.size();
+    if( !l_it->m_ids.empty() )
+      l_maxID = std::max( l_maxID, *std::max_element( l_it->m_ids.begin(),
+                                                      l_it->m_ids.end() ) );
+  }
+
+  m_ids.clear();
+  m_coords.clear();
+  m_used.clear();
+
+  //! Node IDs must fit the index type
+  if( l_maxID > std::numeric_limits< I >::max() )
+    return false;
 
-  real l_edge[6] = { geo::dist( i_A, i_B ), geo::dist( i_A, i_D ),
-                     geo::dist( i_A, i_C ), geo::dist( i_B, i_C ),
-                     geo::dist( i_B, i_D ), geo::dist( i_C, i_D ) };
+  //! Dense IDs (at most half of the slots unused): slot is the ID itself
+  if( l_maxID / 2 <= l_num ) {
+    m_coords.resize( l_maxID + 1 );
+    m_used.assign( l_maxID + 1, false );
 
-  //! Get shortest and longest edge
-  real l_min = std::min( std::min( l_edge[0], l_edge[1] ),
-                         std::min( std::min( l_edge[2], l_edge[3] ),
-                                   std::min( l_edge[4], l_edge[5] ) ) );
-  real l_max = std::max( std::max( l_edge[0], l_edge[1] ),
-                         std::max( std::max( l_edge[2], l_edge[3] ),
-                                   std::max( l_edge[4], l_edge[5] ) ) );
+    for( l_it = i_blocks.begin(); l_it != i_blocks.end(); ++l_it )
+      for( size_t l_i = 0; l_i < l_it->m_ids.size(); l_i++ ) {
+        m_coords[l_it->m_ids[l_i]] = l_it->m_coords[l_i];
+        m_used[l_it->m_ids[l_i]]   = true;
+      }
+
+    return true;
+  }
 
-  //! Quality criterion
-  if( l_cRad / l_iRad > 6.0 && l_max / l_min > 5.0 )
-    m_badElems++;
+  //! Sparse IDs: sort (ID, file position) pairs, keep last of equal IDs
+  std::vector< std::pair< UID, const geo::Vector * > > l_nodes;
+  l_nodes.reserve( l_num );
+  for( l_it = i_blocks.begin(); l_it != i_blocks.end(); ++l_it )
+    for( size_t l_i = 0; l_i < l_it->m_ids.size(); l_i++ )
+      l_nodes.push_back( std::make_pair( l_it->m_ids[l_i], &l_it->m_coords[l_i] ) );
+
+  std::stable_sort( l_nodes.begin(), l_nodes.end(),
+                    []( const std::pair< UID, const geo::Vector * > &i_a,
+                        const std::pair< UID, const geo::Vector * > &i_b ) {
+                      return i_a.first < i_b.first;
+                    } );
+
+  m_ids.reserve( l_num );
+  m_coords.reserve( l_num );
+  for( size_t l_i = 0; l_i < l_nodes.size(); l_i++ ) {
+    if( l_i + 1 < l_nodes.size() && l_nodes[l_i + 1].first == l_nodes[l_i].first )
+      continue;
+
+    m_ids.push_back( l_nodes[l_i].first );
+    m_coords.push_back( *l_nodes[l_i].second );
+  }
+
+  return true;
 }
 
 //! ----------------------------------------------------------------------------
-//! Parse the materials
+//! Slot of node referenced by an element (exits if node is missing)
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::parseMaterials() {
-  //! Open GeoGen.mat file
-  m_inMat.open( "GeoGen.mat", std::ifstream::in );
-  if( !m_inMat.is_open() ) {
-    std::cerr << "Couldn't open GeoGen.mat! Exiting..\n";
+template< typename I, typename R >
+size_t Eureka::Writer< I, R >::nodeSlot( const UID &i_id ) const {
+  size_t l_slot = m_nodes.find( i_id );
+  if( l_slot == Eureka::NodeTable< I, R >::NONE ) {
+    std::cerr << "Node " << i_id << " referenced by an element is missing! Exiting..\n";
     exit( EXIT_FAILURE );
   }
 
-  std::string l_s;
+  return l_slot;
+}
 
-  while( m_inMat ) {
-    if( !std::getline( m_inMat, l_s ) )
-      break;
+//! ----------------------------------------------------------------------------
+//! Slots of the nodes of an element, for pool workers (returns false with the
+//! missing ID in o_missing instead of exiting)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+bool Eureka::Writer< I, R >::elemSlots( const Eureka::Elem< I > &i_elem,
+                                        size_t                  (&o_slots)[4],
+                                        UID                     &o_missing ) const {
+  const I l_nodes[4] = { i_elem.m_node1, i_elem.m_node2, i_elem.m_node3, i_elem.m_node4 };
+
+  for( int l_k = 0; l_k < 4; l_k++ ) {
+    o_slots[l_k] = m_nodes.find( l_nodes[l_k] );
+    if( o_slots[l_k] == Eureka::NodeTable< I, R >::NONE ) {
+      o_missing = l_nodes[l_k];
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Exit on the first missing node recorded per range by pool workers (NONE
+//! where none is missing); called after the run returns
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::checkMissing( const std::vector< UID > &i_missing ) const {
+  for( size_t l_r = 0; l_r < i_missing.size(); l_r++ )
+    if( i_missing[l_r] != Eureka::NodeTable< I, R >::NONE )
+      nodeSlot( i_missing[l_r] );
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse the materials (maps the manifest, see GeoManifest.h for layout)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::parseMaterials() {
+  if( !m_mat.open( m_matFile.c_str() ) ) {
+    std::cerr << "Couldn't open " << m_matFile << "! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  const geo::ManifestHeader *l_header =
+                     reinterpret_cast< const geo::ManifestHeader * >(m_mat.m_data);
+
+  //! Validate header
+  if( m_mat.m_size < sizeof( geo::ManifestHeader ) ||
+      !std::equal( geo::MANIFEST_MAGIC, geo::MANIFEST_MAGIC + 8, l_header->m_magic ) ) {
+    std::cerr << m_matFile << " is not a material manifest! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  if( l_header->m_endian != geo::MANIFEST_ENDIAN ) {
+    std::cerr << m_matFile << " was written with different byte order! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  if( l_header->m_version != geo::MANIFEST_VERSION ) {
+    std::cerr << "Unsupported manifest version (" << l_header->m_version
+              << ")! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  if( l_header->m_fileSize != m_mat.m_size ||
+      m_mat.m_size < sizeof( geo::ManifestHeader ) +
+                     l_header->m_numMaterials * sizeof( geo::ManifestMaterial ) ) {
+    std::cerr << m_matFile << " is truncated! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  const geo::ManifestMaterial *l_table =
+     reinterpret_cast< const geo::ManifestMaterial * >(m_mat.m_data +
+                                                sizeof( geo::ManifestHeader ));
+
+  for( uint64_t l_i = 0; l_i < l_header->m_numMaterials; l_i++ ) {
+    const geo::ManifestMaterial &l_entry = l_table[l_i];
 
     //! Create a new material with read-in name
-    Eureka::Material *l_mat = new Eureka::Material( l_s );
+    Eureka::Material *l_mat = new Eureka::Material(
+                        std::string( l_entry.m_name,
+                                     strnlen( l_entry.m_name, geo::MANIFEST_NAMELEN ) ) );
+    m_matList.push_back( l_mat );
 
     //! Get morphology
-    std::getline( m_inMat, l_s );
-    if( l_s ==  "cyl" )
+    if( l_entry.m_morph == 0 && l_entry.m_cpStride == 6 )
       l_mat->m_morph = geo::Morph::CYLINDER;
-    else if( l_s == "sph" )
+    else if( l_entry.m_morph == 1 && l_entry.m_cpStride == 3 )
       l_mat->m_morph = geo::Morph::SPHERE;
     else {
-      std::cerr << "Unknown morphology (" << l_s << ")! Exiting..\n";
-      m_inMsh.close();
-      m_inMat.close();
-      m_out.close();
+      std::cerr << "Unknown morphology (" << l_entry.m_morph << ")! Exiting..\n";
       exit( EXIT_FAILURE );
     }
 
-    //! Get number of particles
-    std::getline( m_inMat, l_s );
-    l_mat->m_numParticles = StrToUID( l_s );
-
-    //! Reserve vectors
-    l_mat->m_radList.reserve( l_mat->m_numParticles );
-    l_mat->m_cylCP.reserve( l_mat->m_numParticles );
-    l_mat->m_sphCP.reserve( l_mat->m_numParticles );
-
-    //! Read the radius and control points
-    for( UID l_i = 0; l_i < l_mat->m_numParticles; l_i++ ) {
-      std::getline( m_inMat, l_s );
-      std::istringstream l_ss( l_s );
-      std::vector< std::string > l_words;
+    //! Radius and control point arrays must lie inside the file
+    uint64_t l_num = l_entry.m_numParticles;
+    if( l_entry.m_radOffset % sizeof( real ) || l_entry.m_cpOffset % sizeof( real ) ||
+        l_entry.m_radOffset + l_num * sizeof( real ) > m_mat.m_size ||
+        l_entry.m_cpOffset + l_num * l_entry.m_cpStride * sizeof( real ) > m_mat.m_size ) {
+      std::cerr << "Corrupt particle data for " << l_mat->m_name << "! Exiting..\n";
+      exit( EXIT_FAILURE );
+    }
 
-      while( l_ss ) {
-        std::string l_next;
+    l_mat->m_numParticles = l_num;
+    l_mat->m_cpStride     = l_entry.m_cpStride;
+    l_mat->m_radList      = reinterpret_cast< const real * >(m_mat.m_data +
+                                                          l_entry.m_radOffset);
+    l_mat->m_cpList       = reinterpret_cast< const real * >(m_mat.m_data +
+                                                          l_entry.m_cpOffset);
+  }
+}
 
-        //! Get the next string before hitting a space and put it in next
-        if( !std::getline( l_ss, l_next, ' ' ) )
-          break;
+//! ----------------------------------------------------------------------------
+//! Index particles for point-in-particle queries once parsed element blocks
+//! [i_first, i_first + i_num) hold a tet without a known physical volume
+//! (auto labels are sized by the number of elements, each classified by one
+//! query at most)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::buildGrid( const std::vector< Eureka::MshBlock > &i_blocks,
+                                    const size_t                          &i_first,
+                                    const size_t                          &i_num ) {
+  if( m_gridBuilt )
+    return;
+
+  for( size_t l_b = i_first; l_b < i_first + i_num; l_b++ )
+    if( i_blocks[l_b].m_untagged ) {
+      m_grid.build( m_matList, m_labelRes, m_numElems, m_pool );
+      m_gridBuilt = true;
+      return;
+    }
+}
 
-        l_words.push_back( l_next );
-      }
+//! ----------------------------------------------------------------------------
+//! Print voxel labels of particle grid (if built with any)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::printGrid() const {
+  if( !m_gridBuilt || !m_grid.labelled() )
+    return;
+
+  const long *l_dims = m_grid.voxelDims();
+  std::cout << "Particle voxel labels = " << l_dims[0] << "x" << l_dims[1] << "x"
+            << l_dims[2] << ", " << 100.0 * m_grid.mixedFraction()
+            << "% needing containment tests\n";
+}
 
-      //! Should have exactly 7 columns (cyl) or 4 columns (sph)
-      if( l_words.size() != 7 && l_words.size() != 4 )
-        continue;
+//! ----------------------------------------------------------------------------
+//! Predicates of parsed nodes found from their coordinates: box faces
+//! (untagged meshes) and piston (matrix nodes are found from their elements)
+//! ----------------------------------------------------------------------------
+void Eureka::WriterBase::classifyNodes( Eureka::MshBlock &io_block ) const {
+  size_t l_num = io_block.m_ids.size();
+  io_block.m_preds.resize( l_num );
+
+  //! Tagged meshes mark box faces from their triangles
+  real l_faceOn = m_faceMap.empty() ? 1.0 : 0.0;
+  real l_piston = m_height - m_pistonThicc - m_nodeTol;
+
+  //! Bit (as a real) if coordinate lies on plane
+  auto l_on = [&]( real i_x, real i_plane, real i_bit ) {
+    return (std::fabs( i_x - i_plane ) <= m_nodeTol) ? i_bit : 0.0;
+  };
+
+  //! Coordinates of a chunk of nodes, copied into x, y and z arrays so the
+  //! predicates of the chunk run on packed lanes. Predicate bits are summed
+  //! as reals: SSE2 selects doubles but not 64-bit integers
+  const size_t l_chunk = 256;
+  real l_x[l_chunk], l_y[l_chunk], l_z[l_chunk], l_bits[l_chunk];
+  uint16_t *l_preds = io_block.m_preds.data();
+
+  for( size_t l_c = 0; l_c < l_num; l_c += l_chunk ) {
+    size_t l_n = std::min( l_chunk, l_num - l_c );
+    for( size_t l_i = 0; l_i < l_n; l_i++ ) {
+      l_x[l_i] = io_block.m_coords[l_c + l_i].m_x;
+      l_y[l_i] = io_block.m_coords[l_c + l_i].m_y;
+      l_z[l_i] = io_block.m_coords[l_c + l_i].m_z;
+    }
 
-      //! Populate radius and control point list
-      l_mat->m_radList.push_back( StrToReal( l_words[0] ) );
-
-      switch( l_mat->m_morph ) {
-        case geo::Morph::CYLINDER:
-          l_mat->m_cylCP.push_back( std::make_pair(
-                                      geo::Vector( StrToReal( l_words[1] ),
-                                                   StrToReal( l_words[2] ),
-                                                   StrToReal( l_words[3] ) ),
-                                      geo::Vector( StrToReal( l_words[4] ),
-                                                   StrToReal( l_words[5] ),
-                                                   StrToReal( l_words[6] ) ) ) );
-          break;
-
-        case geo::Morph::SPHERE:
-          l_mat->m_sphCP.push_back( geo::Vector( StrToReal( l_words[1] ),
-                                                 StrToReal( l_words[2] ),
-                                                 StrToReal( l_words[3] ) ) );
-          break;
-      }
+#pragma omp simd
+    for( size_t l_i = 0; l_i < l_n; l_i++ ) {
+      real l_faces = l_on( l_z[l_i], m_height, Eureka::Face::TOP    ) +
+                     l_on( l_z[l_i], 0.0,      Eureka::Face::BOTTOM ) +
+                     l_on( l_x[l_i], 0.0,      Eureka::Face::LEFT   ) +
+                     l_on( l_x[l_i], m_length, Eureka::Face::RIGHT  ) +
+                     l_on( l_y[l_i], 0.0,      Eureka::Face::FRONT  ) +
+                     l_on( l_y[l_i], m_width,  Eureka::Face::BACK   );
+
+      l_bits[l_i] = l_faceOn * l_faces +
+                    ((l_z[l_i] >= l_piston) ? (real) Eureka::PISTONNODE : 0.0);
     }
 
-    //! Populate material list
-    m_matList.push_back( l_mat );
+    for( size_t l_i = 0; l_i < l_n; l_i++ )
+      l_preds[l_c + l_i] = (uint16_t) l_bits[l_i];
   }
 }
 
 //! ----------------------------------------------------------------------------
-//! Read in nodes from msh file
+//! Read in nodes from msh file (returns false if node IDs exceed the index
+//! type)
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::readNodes() {
+template< typename I, typename R >
+bool Eureka::Writer< I, R >::readNodes() {
   //! Start time
   clock_t l_time = clock();
 
   std::cout << "Reading in nodes.. " << std::flush;
-  std::string l_s;
 
-  //! Skip first four lines
-  for( int l_i = 0; l_i <= 4; l_i++ )
-    std::getline( m_inMsh, l_s );
+  //! Skip to nodes section while picking up format, physical names and
+  //! entities on the way
+  findSection( "$Nodes" );
 
-  //! Get number of nodes from next line
-  m_numOfNodes = StrToUID( l_s );
+  std::vector< Eureka::MshBlock > l_blocks;
+  splitNodes( l_blocks );
 
-  //! Store in node-info while skipping those lines for now
-  for( UID l_i = 0; l_i < m_numOfNodes; l_i++ ) {
-    std::getline( m_inMsh, l_s );
+  //! Parse and classify blocks in parallel
+  m_pool.run( l_blocks.size(), [&]( size_t i_b, unsigned int ) {
+    parseNodes( l_blocks[i_b] );
+    classifyNodes( l_blocks[i_b] );
+  } );
 
-    std::istringstream l_ss( l_s );
-    std::vector< std::string > l_words;
+  checkBlocks( "node", l_blocks );
 
-    while( l_ss ) {
-      std::string l_next;
+  //! Populate node table
+  if( !m_nodes.build( l_blocks ) ) {
+    std::cout << "Node IDs exceed " << 8 * sizeof( I ) << "-bit indices\n";
+    return false;
+  }
 
-      //! Get the next string before hitting a space and put it in next
-      if( !std::getline( l_ss, l_next, ' ' ) )
-        break;
+  m_nodePreds.assign( m_nodes.size(), 0 );
 
-      l_words.push_back( l_next );
-    }
+  //! Merge predicates in file order (only boundary and piston nodes have any)
+  std::vector< Eureka::MshBlock >::iterator l_it;
+  for( l_it = l_blocks.begin(); l_it != l_blocks.end(); ++l_it ) {
+    for( size_t l_i = 0; l_i < l_it->m_ids.size(); l_i++ )
+      if( l_it->m_preds[l_i] )
+        m_nodePreds[m_nodes.find( l_it->m_ids[l_i] )] = l_it->m_preds[l_i];
 
-    //! We should have exactly 4 columns
-    if( l_words.size() != 4 )
-      continue;
-
-    UID l_id = StrToUID(  l_words[0] );
-    real l_x = StrToReal( l_words[1] );
-    real l_y = StrToReal( l_words[2] );
-    real l_z = StrToReal( l_words[3] );
+    *l_it = Eureka::MshBlock();
+  }
 
-    //! Populate node map
-    m_nodeMap[l_id] = geo::Vector( l_x, l_y, l_z );
+  //! End time
+  l_time = clock() - l_time;
+  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
 
-    //! top_nodes
-    if( l_z == m_height )
-      m_topNodes.push_back( l_id );
+  return true;
+}
 
-    //! bottom_nodes
-    if( l_z == 0.0 )
-      m_bottomNodes.push_back( l_id );
+//! ----------------------------------------------------------------------------
+//! Element groups (matrix, piston and materials) in the order physical
+//! volumes map to
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::elemGroups( std::vector< std::vector< I > * > &o_groups ) {
+  m_matElems.resize( m_matList.size() );
+
+  o_groups.clear();
+  o_groups.push_back( &m_matrixList );
+  o_groups.push_back( &m_pistonList );
+  for( size_t l_m = 0; l_m < m_matElems.size(); l_m++ )
+    o_groups.push_back( &m_matElems[l_m] );
+}
 
-    //! left_nodes
-    if( l_x == 0.0 )
-      m_leftNodes.push_back( l_id );
+//! ----------------------------------------------------------------------------
+//! Classify and check quality of the tets of a parsed block (IDs from
+//! i_firstID): fills their connectivity and quality, the IDs of every element
+//! group and of the bad elements, and flags the nodes of matrix tets (stops
+//! at the first missing node)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::classifyElems( const Eureka::MshBlock             &i_block,
+                                            const UID                          &i_firstID,
+                                            Eureka::Elem< I >                  *o_elems,
+                                            float                              *o_qual,
+                                            std::vector< std::vector< I > >    &o_lists,
+                                            std::vector< I >                   &o_bad,
+                                            std::vector< std::atomic< bool > > &io_inMatrix,
+                                            const UID                         *&o_missing ) const {
+  const std::vector< UID > &l_tets = i_block.m_tets;
+  UID l_numTets = l_tets.size() / 5;
+
+  //! Element IDs must fit the index type
+  if( i_firstID + l_numTets - 1 > std::numeric_limits< I >::max() ) {
+    std::cerr << "Element IDs exceed " << 8 * sizeof( I ) << "-bit indices (set "
+              << "index_width=64)! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
 
-    //! right_nodes
-    if( l_x == m_length )
-      m_rightNodes.push_back( l_id );
+  for( UID l_t = 0; l_t < l_numTets; l_t += Eureka::QUALBATCH ) {
+    int l_num = (int) std::min( (UID) Eureka::QUALBATCH, l_numTets - l_t );
+    Eureka::TetBatch l_batch;
+    size_t l_slot[Eureka::QUALBATCH][4];
+
+    for( int l_j = 0; l_j < Eureka::QUALBATCH; l_j++ ) {
+      //! Unused lanes repeat the first tet
+      const UID *l_tet = &l_tets[5 * (l_t + ((l_j < l_num) ? l_j : 0))];
+
+      //! Populate connectivity
+      if( l_j < l_num )
+        o_elems[l_t + l_j] = Eureka::Elem< I >( l_tet[1], l_tet[2], l_tet[3], l_tet[4] );
+
+      //! Get nodes
+      for( int l_k = 0; l_k < 4; l_k++ ) {
+        l_slot[l_j][l_k] = m_nodes.find( l_tet[1 + l_k] );
+        if( l_slot[l_j][l_k] == Eureka::NodeTable< I, R >::NONE ) {
+          o_missing = &l_tet[1 + l_k];
+          return;
+        }
 
-    //! front_nodes
-    if( l_y == 0.0 )
-      m_frontNodes.push_back( l_id );
+        const geo::Vector &l_node = m_nodes.m_coords[l_slot[l_j][l_k]];
+        l_batch.m_x[l_k][l_j] = l_node.m_x;
+        l_batch.m_y[l_k][l_j] = l_node.m_y;
+        l_batch.m_z[l_k][l_j] = l_node.m_z;
+      }
+    }
 
-    //! back_nodes
-    if( l_y == m_width )
-      m_backNodes.push_back( l_id );
+    //! Element quality check
+    real l_qual[Eureka::QUALBATCH];
+    bool l_isBad[Eureka::QUALBATCH];
+    m_qual.eval( l_batch, l_qual, l_isBad );
+
+    for( int l_j = 0; l_j < l_num; l_j++ ) {
+      const UID *l_tet = &l_tets[5 * (l_t + l_j)];
+      UID l_id = i_firstID + l_t + l_j;
+
+      o_qual[l_t + l_j] = (float) l_qual[l_j];
+      if( l_isBad[l_j] )
+        o_bad.push_back( l_id );
+
+      //! Calculate centroid (P) of tet
+      real l_x = (l_batch.m_x[0][l_j] + l_batch.m_x[1][l_j] +
+                  l_batch.m_x[2][l_j] + l_batch.m_x[3][l_j]) / 4.0;
+      real l_y = (l_batch.m_y[0][l_j] + l_batch.m_y[1][l_j] +
+                  l_batch.m_y[2][l_j] + l_batch.m_y[3][l_j]) / 4.0;
+      real l_z = (l_batch.m_z[0][l_j] + l_batch.m_z[1][l_j] +
+                  l_batch.m_z[2][l_j] + l_batch.m_z[3][l_j]) / 4.0;
+      geo::Vector l_P( l_x, l_y, l_z );
+
+      size_t l_group;
+
+      //! Tet tagged by a known physical volume needs no geometric search
+      std::map< UID, size_t >::const_iterator l_tagIt = m_physMap.find( l_tet[0] );
+      if( l_tagIt != m_physMap.end() )
+        l_group = l_tagIt->second;
+
+      //! Check if tet lies inside piston
+      else if( l_z >= (m_height - m_pistonThicc) )
+        l_group = 1;
+
+      //! Check if tet lies inside any of the particles, else it lies in matrix
+      else {
+        int l_mat = m_grid.find( l_P );
+        l_group = (l_mat >= 0) ? 2 + l_mat : 0;
+      }
 
-    //! corner_nodes
-    if( (l_x == 0.0 || l_x == m_length) &&
-        (l_y == 0.0 || l_y == m_width)  && l_z == 0.0 )
-      m_cornerNodes.push_back( l_id );
+      o_lists[l_group].push_back( l_id );
 
-    //! top_corner_nodes
-    if( (l_x == 0.0 || l_x == m_length) &&
-        (l_y == 0.0 || l_y == m_width)  && l_z == m_height )
-      m_topCornerNodes.push_back( l_id );
+      if( l_group == 0 )
+        for( int l_k = 0; l_k < 4; l_k++ )
+          io_inMatrix[l_slot[l_j][l_k]].store( true, std::memory_order_relaxed );
+    }
+  }
+}
 
-    //! zleft_nodes
-    if( l_x == 0.0 && (l_y == 0.0 || l_y == m_width) )
-      m_zLeftNodes.push_back( l_id );
+//! ----------------------------------------------------------------------------
+//! Read in elements from msh file
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::readElems() {
+  //! Start time
+  clock_t l_time = clock();
 
-    //! zright_nodes
-    if( l_x == m_length && (l_y == 0.0 || l_y == m_width) )
-      m_zRightNodes.push_back( l_id );
+  std::cout << "Reading in elems.. " << std::flush;
 
-    //! yleft_nodes
-    if( l_x == 0.0 && l_z == 0.0 )
-      m_yLeftNodes.push_back( l_id );
+  findSection( "$Elements" );
 
-    //! yright_nodes
-    if( l_x == m_length && l_z == 0.0 )
-      m_yRightNodes.push_back( l_id );
+  std::vector< Eureka::MshBlock > l_blocks;
+  splitElems( l_blocks );
 
-    //! xfront_nodes
-    if( l_y == 0.0 && l_z == 0.0 )
-      m_xFrontNodes.push_back( l_id );
+  //! Parse blocks in parallel
+  m_pool.run( l_blocks.size(), [&]( size_t i_b, unsigned int ) {
+    parseElems( l_blocks[i_b] );
+  } );
 
-    //! xback_nodes
-    if( l_y == m_width && l_z == 0.0 )
-      m_xBackNodes.push_back( l_id );
+  checkBlocks( "element", l_blocks );
 
-    //! Piston nodes
-    if( l_z >= (m_height - m_pistonThicc) ) {
-      m_pistonNodes.push_back( l_id );
-      continue;
-    }
+  //! Particle grid, if some tet needs it
+  buildGrid( l_blocks, 0, l_blocks.size() );
 
-    geo::Vector l_P( l_x, l_y, l_z );
-    bool l_matPt = false;
+  //! Mark box faces of nodes on tagged triangles
+  std::vector< Eureka::MshBlock >::const_iterator l_blockIt;
+  for( l_blockIt = l_blocks.begin(); l_blockIt != l_blocks.end(); ++l_blockIt ) {
+    std::vector< std::pair< UID, unsigned char > >::const_iterator l_faceIt;
+    for( l_faceIt = l_blockIt->m_faceNodes.begin();
+         l_faceIt != l_blockIt->m_faceNodes.end(); ++l_faceIt )
+      m_nodePreds[nodeSlot( l_faceIt->first )] |= l_faceIt->second;
+  }
 
-    //! Check if node lies inside any particle
-    std::vector< Eureka::Material * >::const_iterator l_it;
-    for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it ) {
-      //! Temporary material pointer
-      Eureka::Material *l_mat = *l_it;
+  std::vector< std::vector< I > * > l_groups;
+  elemGroups( l_groups );
 
-      l_matPt = false;
-      real l_c1 = 0.0, l_c2 = 0.0, l_d = 0.0;
-      geo::Vector l_A, l_B, l_AB, l_BA, l_AP, l_BP;
+  //! First element ID of every block (element IDs follow the order of the tets)
+  size_t l_numBlocks = l_blocks.size();
+  std::vector< UID > l_firstID( l_numBlocks + 1, m_elemID );
+  for( size_t l_b = 0; l_b < l_numBlocks; l_b++ )
+    l_firstID[l_b + 1] = l_firstID[l_b] + l_blocks[l_b].m_tets.size() / 5;
 
-      for( UID l_i = 0; l_i < l_mat->m_numParticles; l_i++ ) {
-        if( l_mat->m_morph == geo::Morph::CYLINDER ) {
-          //! A & B are end pts of cylinder axis
-          l_A  = l_mat->m_cylCP[l_i].first;
-          l_B  = l_mat->m_cylCP[l_i].second;
+  m_elems.resize( l_firstID.back() - 1 );
+  m_elemQual.resize( m_elems.size() );
 
-          //! Define vectors
-          l_AB = geo::Vector( l_A, l_B );
-          l_BA = geo::Vector( l_B, l_A );
-          l_AP = geo::Vector( l_A, l_P );
-          l_BP = geo::Vector( l_B, l_P );
+  //! Block-local element groups, bad elements and missing nodes
+  std::vector< std::vector< std::vector< I > > > l_lists( l_numBlocks,
+                                      std::vector< std::vector< I > >( l_groups.size() ) );
+  std::vector< std::vector< I > > l_bad( l_numBlocks );
+  std::vector< const UID * > l_missing( l_numBlocks, nullptr );
 
-          //! AB.AP
-          l_c1 = geo::dot( l_AB, l_AP );
+  //! Nodes (by slot) of matrix tets
+  std::vector< std::atomic< bool > > l_inMatrix( m_nodes.size() );
 
-          //! BA.BP
-          l_c2 = geo::dot( l_BA, l_BP );
+  //! Classify and check quality of blocks in parallel
+  m_pool.run( l_numBlocks, [&]( size_t i_b, unsigned int ) {
+    UID l_offset = l_firstID[i_b] - 1;
+    classifyElems( l_blocks[i_b], l_firstID[i_b], &m_elems[l_offset], &m_elemQual[l_offset],
+                   l_lists[i_b], l_bad[i_b], l_inMatrix, l_missing[i_b] );
+  } );
 
-          //! Distance of P from line joining A & B
-          l_d  = geo::norm( geo::cross( l_AP, l_BP ) ) / geo::norm( l_AB );
+  //! First missing node in file order
+  for( size_t l_b = 0; l_b < l_numBlocks; l_b++ )
+    if( l_missing[l_b] )
+      nodeSlot( *l_missing[l_b] );
 
-          //! Point lying inside cylinder
-          if( l_c1 >= 0.0 && l_c2 >= 0.0 && l_d <= l_mat->m_radList[l_i] ) {
-            l_matPt = true;
-            break;
-          }
-        }
+  //! Merge groups and counters in element ID order
+  for( size_t l_g = 0; l_g < l_groups.size(); l_g++ )
+    for( size_t l_b = 0; l_b < l_numBlocks; l_b++ )
+      l_groups[l_g]->insert( l_groups[l_g]->end(), l_lists[l_b][l_g].begin(),
+                             l_lists[l_b][l_g].end() );
 
-        else if( l_mat->m_morph == geo::Morph::SPHERE ) {
-          //! Point lying inside sphere
-          if( geo::dist( l_P, l_mat->m_sphCP[l_i] ) <= l_mat->m_radList[l_i] ) {
-            l_matPt = true;
-            break;
-          }
-        }
-      }
+  for( size_t l_b = 0; l_b < l_numBlocks; l_b++ )
+    m_badList.insert( m_badList.end(), l_bad[l_b].begin(), l_bad[l_b].end() );
 
-      //! Skip checking further materials as 1 node belongs in 1 material
-      if( l_matPt )
-        break;
-    }
+  m_elemID = l_firstID.back();
 
-    //! If not belonging to either material or piston means pt lies in matrix
-    if( !l_matPt )
-      m_matrixNodes.push_back( l_id );
-  }
+  markMatrixNodes( l_inMatrix );
 
   //! End time
   l_time = clock() - l_time;
   std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+
+  printGrid();
 }
 
 //! ----------------------------------------------------------------------------
-//! Read in elements from msh file
+//! Set matrix predicate of the nodes of matrix tets
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::readElems() {
-  //! Start time
-  clock_t l_time = clock();
+template< typename I, typename R >
+void Eureka::Writer< I, R >::markMatrixNodes( const std::vector< std::atomic< bool > > &i_inMatrix ) {
+  size_t l_numSlots = m_nodePreds.size();
+  size_t l_ranges   = 4 * m_pool.size();
+
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_s = i_r * l_numSlots / l_ranges; l_s < (i_r + 1) * l_numSlots / l_ranges; l_s++ )
+      if( i_inMatrix[l_s].load( std::memory_order_relaxed ) )
+        m_nodePreds[l_s] |= Eureka::MATRIXNODE;
+  } );
+}
 
-  std::cout << "Reading in elems.. " << std::flush;
-  std::string l_s;
+//! ----------------------------------------------------------------------------
+//! Nodal groups holding the nodes of every predicate mask
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::nodeGroupsOf( std::vector< std::vector< unsigned int > > &o_groupsOf ) const {
+  o_groupsOf.assign( Eureka::NODEMASKS, std::vector< unsigned int >() );
+  for( size_t l_m = 0; l_m < Eureka::NODEMASKS; l_m++ )
+    for( size_t l_g = 0; l_g < m_nodeGroupDefs.size(); l_g++ )
+      if( m_nodeGroupDefs.contains( l_g, l_m ) )
+        o_groupsOf[l_m].push_back( l_g );
+}
 
-  while( m_inMsh ) {
-    if( !std::getline( m_inMsh, l_s ) )
-      break;
+//! ----------------------------------------------------------------------------
+//! Build nodal groups from the node predicates in one counting and one
+//! filling pass over the nodes (in parallel over ranges of slots, each range
+//! filling its part of every group, so groups stay in ID order)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::buildNodalGroups() {
+  size_t l_numGroups = m_nodeGroupDefs.size();
+  size_t l_numSlots  = m_nodePreds.size();
+  size_t l_ranges    = 4 * m_pool.size();
+
+  std::vector< std::vector< unsigned int > > l_groupsOf;
+  nodeGroupsOf( l_groupsOf );
+
+  //! Group sizes per range, then start of every range in every group
+  std::vector< std::vector< UID > > l_start( l_ranges + 1, std::vector< UID >( l_numGroups, 0 ) );
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_s = i_r * l_numSlots / l_ranges; l_s < (i_r + 1) * l_numSlots / l_ranges; l_s++ )
+      if( m_nodes.used( l_s ) ) {
+        const std::vector< unsigned int > &l_groups = l_groupsOf[m_nodePreds[l_s]];
+        for( size_t l_k = 0; l_k < l_groups.size(); l_k++ )
+          l_start[i_r + 1][l_groups[l_k]]++;
+      }
+  } );
+
+  for( size_t l_r = 0; l_r < l_ranges; l_r++ )
+    for( size_t l_g = 0; l_g < l_numGroups; l_g++ )
+      l_start[l_r + 1][l_g] += l_start[l_r][l_g];
+
+  m_nodeGroups.assign( l_numGroups, std::vector< I >() );
+  for( size_t l_g = 0; l_g < l_numGroups; l_g++ )
+    m_nodeGroups[l_g].resize( l_start[l_ranges][l_g] );
+
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    std::vector< UID > &l_pos = l_start[i_r];
+    for( size_t l_s = i_r * l_numSlots / l_ranges; l_s < (i_r + 1) * l_numSlots / l_ranges; l_s++ )
+      if( m_nodes.used( l_s ) ) {
+        const std::vector< unsigned int > &l_groups = l_groupsOf[m_nodePreds[l_s]];
+        for( size_t l_k = 0; l_k < l_groups.size(); l_k++ )
+          m_nodeGroups[l_groups[l_k]][l_pos[l_groups[l_k]]++] = m_nodes.id( l_s );
+      }
+  } );
+}
 
-    //! Ignore lines starting with '$'
-    if( l_s[0] == '$' )
-      continue;
+//! ----------------------------------------------------------------------------
+//! Centroid of every element (ID i at i - 1)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::elemCentroids( std::vector< geo::Vector > &o_centroids ) {
+  size_t l_numElems = m_elems.size();
+  size_t l_ranges   = 4 * m_pool.size();
+
+  //! First missing node of every range
+  std::vector< UID > l_missing( l_ranges, Eureka::NodeTable< I, R >::NONE );
+
+  o_centroids.resize( l_numElems );
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_e = i_r * l_numElems / l_ranges; l_e < (i_r + 1) * l_numElems / l_ranges; l_e++ ) {
+      size_t l_s[4];
+      if( !elemSlots( m_elems[l_e], l_s, l_missing[i_r] ) )
+        return;
+
+      const geo::Vector &l_P1 = m_nodes.m_coords[l_s[0]];
+      const geo::Vector &l_P2 = m_nodes.m_coords[l_s[1]];
+      const geo::Vector &l_P3 = m_nodes.m_coords[l_s[2]];
+      const geo::Vector &l_P4 = m_nodes.m_coords[l_s[3]];
+
+      o_centroids[l_e] = geo::Vector( 0.25 * (l_P1.m_x + l_P2.m_x + l_P3.m_x + l_P4.m_x),
+                                      0.25 * (l_P1.m_y + l_P2.m_y + l_P3.m_y + l_P4.m_y),
+                                      0.25 * (l_P1.m_z + l_P2.m_z + l_P3.m_z + l_P4.m_z) );
+    }
+  } );
+
+  checkMissing( l_missing );
+}
 
-    std::istringstream l_ss( l_s );
-    std::vector< std::string > l_words;
+//! ----------------------------------------------------------------------------
+//! Renumber elements (IDs 1..E) in the order of their centroids along the
+//! selected curve, remapping element groups
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::renumberElems() {
+  if( m_elemOrder == Eureka::Ordering::NONE )
+    return;
+
+  //! Start time
+  clock_t l_time = clock();
+
+  std::cout << "Renumbering elements (" << Eureka::orderingName( m_elemOrder ) << ").. "
+            << std::flush;
 
-    while( l_ss ) {
-      std::string l_next;
+  size_t l_numElems = m_elems.size();
+  size_t l_ranges   = 4 * m_pool.size();
 
-      //! Get the next string before hitting a space and put it in next
-      if( !std::getline( l_ss, l_next, ' ' ) )
-        break;
+  std::vector< geo::Vector > l_centroids;
+  elemCentroids( l_centroids );
 
-      l_words.push_back( l_next );
+  //! Old index of the element getting ID i + 1
+  std::vector< UID > l_order;
+  Eureka::curveOrder( m_elemOrder, l_centroids, m_pool, l_order );
+
+  //! New ID of every element, permuted connectivity and quality
+  std::vector< UID > l_newID( l_numElems );
+  std::vector< Eureka::Elem< I > > l_elems( l_numElems );
+  std::vector< float > l_elemQual( l_numElems );
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_i = i_r * l_numElems / l_ranges; l_i < (i_r + 1) * l_numElems / l_ranges; l_i++ ) {
+      l_newID[l_order[l_i]] = l_i + 1;
+      l_elems[l_i]          = m_elems[l_order[l_i]];
+      l_elemQual[l_i]       = m_elemQual[l_order[l_i]];
     }
+  } );
+
+  m_elems.swap( l_elems );
+  m_elemQual.swap( l_elemQual );
+
+  //! Remap element groups, keeping them in ID order
+  std::vector< std::vector< I > * > l_groups;
+  l_groups.push_back( &m_matrixList );
+  l_groups.push_back( &m_pistonList );
+  l_groups.push_back( &m_badList );
+  for( size_t l_m = 0; l_m < m_matList.size(); l_m++ )
+    l_groups.push_back( &m_matElems[l_m] );
+
+  m_pool.run( l_groups.size(), [&]( size_t i_g, unsigned int ) {
+    typename std::vector< I >::iterator l_it;
+    for( l_it = l_groups[i_g]->begin(); l_it != l_groups[i_g]->end(); ++l_it )
+      *l_it = l_newID[*l_it - 1];
+    std::sort( l_groups[i_g]->begin(), l_groups[i_g]->end() );
+  } );
 
-    //! We should have exactly 9 columns
-    if( l_words.size() != 9 )
-      continue;
+  l_time = clock() - l_time;
+  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+}
 
-    //! Only check for tets
-    if( l_words[1] != "4" )
-      continue;
+//! ----------------------------------------------------------------------------
+//! Renumber nodes (IDs 1..N) in the selected order, remapping element
+//! connectivity and nodal groups
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::renumberNodes() {
+  if( m_nodeOrder == Eureka::Ordering::NONE )
+    return;
 
-    UID l_n1 = StrToUID( l_words[5] );
-    UID l_n2 = StrToUID( l_words[6] );
-    UID l_n3 = StrToUID( l_words[7] );
-    UID l_n4 = StrToUID( l_words[8] );
+  //! Start time
+  clock_t l_time = clock();
 
-    //! Populate elem map
-    m_elemMap[m_elemID] = Eureka::Elem( l_n1, l_n2, l_n3, l_n4 );
+  std::cout << "Renumbering nodes (" << Eureka::orderingName( m_nodeOrder ) << ").. "
+            << std::flush;
+
+  //! Used slots and their compact index
+  std::vector< size_t > l_slots;
+  std::vector< UID > l_index( m_nodes.size(), 0 );
+  l_slots.reserve( m_nodes.size() );
+  for( size_t l_slot = 0; l_slot < m_nodes.size(); l_slot++ )
+    if( m_nodes.used( l_slot ) ) {
+      l_index[l_slot] = l_slots.size();
+      l_slots.push_back( l_slot );
+    }
 
-    //! Get nodes
-    geo::Vector l_node1 = m_nodeMap[l_n1];
-    geo::Vector l_node2 = m_nodeMap[l_n2];
-    geo::Vector l_node3 = m_nodeMap[l_n3];
-    geo::Vector l_node4 = m_nodeMap[l_n4];
+  size_t l_numElems = m_elems.size();
+  size_t l_ranges   = 4 * m_pool.size();
+
+  //! First missing node of every range
+  std::vector< UID > l_missing( l_ranges, Eureka::NodeTable< I, R >::NONE );
+
+  //! Largest ID difference within an element
+  auto l_bandwidth = [&]() {
+    std::vector< UID > l_max( l_ranges, 0 );
+    m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+      for( size_t l_e = i_r * l_numElems / l_ranges; l_e < (i_r + 1) * l_numElems / l_ranges; l_e++ ) {
+        const Eureka::Elem< I > &l_elem = m_elems[l_e];
+        UID l_lo = std::min( { l_elem.m_node1, l_elem.m_node2, l_elem.m_node3, l_elem.m_node4 } );
+        UID l_hi = std::max( { l_elem.m_node1, l_elem.m_node2, l_elem.m_node3, l_elem.m_node4 } );
+        l_max[i_r] = std::max( l_max[i_r], l_hi - l_lo );
+      }
+    } );
+    return *std::max_element( l_max.begin(), l_max.end() );
+  };
+
+  UID l_oldBandwidth = l_bandwidth();
+
+  //! New order of compact indices
+  std::vector< UID > l_order;
+  if( m_nodeOrder == Eureka::Ordering::RCM ) {
+    std::vector< UID > l_tets( 4 * l_numElems );
+    m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+      for( size_t l_e = i_r * l_numElems / l_ranges; l_e < (i_r + 1) * l_numElems / l_ranges; l_e++ ) {
+        size_t l_s[4];
+        if( !elemSlots( m_elems[l_e], l_s, l_missing[i_r] ) )
+          return;
+
+        for( int l_k = 0; l_k < 4; l_k++ )
+          l_tets[4 * l_e + l_k] = l_index[l_s[l_k]];
+      }
+    } );
+    checkMissing( l_missing );
 
-    //! Element quality check
-    checkElemQual( l_node1, l_node2, l_node3, l_node4 );
+    Eureka::Graph l_graph;
+    l_graph.build( l_slots.size(), l_tets, m_pool );
+    Eureka::rcmOrder( l_graph, l_order );
+  }
+  else {
+    std::vector< geo::Vector > l_points( l_slots.size() );
+    for( size_t l_i = 0; l_i < l_slots.size(); l_i++ )
+      l_points[l_i] = m_nodes.m_coords[l_slots[l_i]];
 
-    //! Calculate centroid (P) of tet
-    real l_x = (l_node1.m_x + l_node2.m_x + l_node3.m_x + l_node4.m_x) / 4.0;
-    real l_y = (l_node1.m_y + l_node2.m_y + l_node3.m_y + l_node4.m_y) / 4.0;
-    real l_z = (l_node1.m_z + l_node2.m_z + l_node3.m_z + l_node4.m_z) / 4.0;
-    geo::Vector l_P( l_x, l_y, l_z );
+    Eureka::curveOrder( m_nodeOrder, l_points, m_pool, l_order );
+  }
 
-    //! Check if tet lies inside piston
-    if( l_z >= (m_height - m_pistonThicc) ) {
-      m_pistonList.push_back( m_elemID++ );
-      continue;
+  //! New ID of every used slot
+  std::vector< UID > l_newID( m_nodes.size(), 0 );
+  for( size_t l_i = 0; l_i < l_order.size(); l_i++ )
+    l_newID[l_slots[l_order[l_i]]] = l_i + 1;
+
+  //! Remap connectivity
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_e = i_r * l_numElems / l_ranges; l_e < (i_r + 1) * l_numElems / l_ranges; l_e++ ) {
+      Eureka::Elem< I > &l_elem = m_elems[l_e];
+      size_t l_s[4];
+      if( !elemSlots( l_elem, l_s, l_missing[i_r] ) )
+        return;
+
+      l_elem.m_node1 = l_newID[l_s[0]];
+      l_elem.m_node2 = l_newID[l_s[1]];
+      l_elem.m_node3 = l_newID[l_s[2]];
+      l_elem.m_node4 = l_newID[l_s[3]];
     }
+  } );
+  checkMissing( l_missing );
+
+  //! Remap nodal groups, keeping them in ID order
+  m_pool.run( m_nodeGroups.size(), [&]( size_t i_g, unsigned int ) {
+    typename std::vector< I >::iterator l_it;
+    for( l_it = m_nodeGroups[i_g].begin(); l_it != m_nodeGroups[i_g].end(); ++l_it )
+      *l_it = l_newID[m_nodes.find( *l_it )];
+    std::sort( m_nodeGroups[i_g].begin(), m_nodeGroups[i_g].end() );
+  } );
+
+  //! Dense node table (and predicates) in the new order
+  Eureka::NodeTable< I, R > l_nodes;
+  std::vector< uint16_t > l_preds( l_order.size() + 1, 0 );
+  l_nodes.m_coords.resize( l_order.size() + 1 );
+  l_nodes.m_used.assign( l_order.size() + 1, true );
+  l_nodes.m_used[0] = false;
+  for( size_t l_i = 0; l_i < l_order.size(); l_i++ ) {
+    l_nodes.m_coords[l_i + 1] = m_nodes.m_coords[l_slots[l_order[l_i]]];
+    l_preds[l_i + 1]          = m_nodePreds[l_slots[l_order[l_i]]];
+  }
 
-    bool l_found = false;
-    //! Check if tet lies inside any of the particles
-    std::vector< Eureka::Material * >::const_iterator l_it;
-    for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it ) {
-      //! Temporary material pointer
-      Eureka::Material *l_mat = *l_it;
+  m_nodes = std::move( l_nodes );
+  m_nodePreds.swap( l_preds );
 
-      l_found = false;
-      real l_c1 = 0.0, l_c2 = 0.0, l_d = 0.0;
-      geo::Vector l_A, l_B, l_AB, l_BA, l_AP, l_BP;
+  l_time = clock() - l_time;
+  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+  std::cout << "Node bandwidth = " << l_oldBandwidth << " -> " << l_bandwidth() << "\n";
+}
 
-      for( UID l_i = 0; l_i < l_mat->m_numParticles; l_i++ ) {
-        if( l_mat->m_morph == geo::Morph::CYLINDER ) {
-          //! A & B are end pts of cylinder axis
-          geo::Vector l_A = l_mat->m_cylCP[l_i].first;
-          geo::Vector l_B = l_mat->m_cylCP[l_i].second;
+//! ----------------------------------------------------------------------------
+//! Print quality histogram of every element group
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::printQuality() const {
+  if( m_qualBins <= 0 )
+    return;
+
+  //! Range of (finite) quality over all elements
+  float l_min = 0.0f, l_max = 0.0f;
+  bool l_first = true;
+  std::vector< float >::const_iterator l_qIt;
+  for( l_qIt = m_elemQual.begin(); l_qIt != m_elemQual.end(); ++l_qIt ) {
+    if( !std::isfinite( *l_qIt ) )
+      continue;
 
-          //! Define vectors
-          l_AB = geo::Vector( l_A, l_B );
-          l_BA = geo::Vector( l_B, l_A );
-          l_AP = geo::Vector( l_A, l_P );
-          l_BP = geo::Vector( l_B, l_P );
+    l_min = l_first ? *l_qIt : std::min( l_min, *l_qIt );
+    l_max = l_first ? *l_qIt : std::max( l_max, *l_qIt );
+    l_first = false;
+  }
 
-          //! AB.AP
-          l_c1 = geo::dot( l_AB, l_AP );
+  real l_width = (l_max > l_min) ? (real) (l_max - l_min) / m_qualBins : 1.0;
+
+  //! Element groups in .dat order
+  std::vector< std::pair< std::string, const std::vector< I > * > > l_groups;
+  l_groups.push_back( std::make_pair( std::string( "matrix" ), &m_matrixList ) );
+  l_groups.push_back( std::make_pair( std::string( "Piston" ), &m_pistonList ) );
+  for( size_t l_m = 0; l_m < m_matList.size(); l_m++ )
+    l_groups.push_back( std::make_pair( m_matList[l_m]->m_name,
+                                        &m_matElems[l_m] ) );
+
+  std::cout << "Element quality (" << m_qual.name() << ", bad beyond "
+            << m_qual.threshold() << "):\n";
+
+  for( size_t l_g = 0; l_g < l_groups.size(); l_g++ ) {
+    const std::vector< I > &l_list = *l_groups[l_g].second;
+    std::vector< UID > l_count( m_qualBins, 0 );
+    UID l_degenerate = 0;
+
+    typename std::vector< I >::const_iterator l_it;
+    for( l_it = l_list.begin(); l_it != l_list.end(); ++l_it ) {
+      float l_q = m_elemQual[*l_it - 1];
+      if( !std::isfinite( l_q ) ) {
+        l_degenerate++;
+        continue;
+      }
 
-          //! BA.BP
-          l_c2 = geo::dot( l_BA, l_BP );
+      long l_bin = (long) ((l_q - l_min) / l_width);
+      l_count[std::min( std::max( l_bin, 0L ), (long) m_qualBins - 1 )]++;
+    }
 
-          //! Distance of P from line joining A & B
-          l_d  = geo::norm( geo::cross( l_AP, l_BP ) ) / geo::norm( l_AB );
+    std::cout << "  " << l_groups[l_g].first << " (" << l_list.size() << " elems)\n";
+    for( int l_b = 0; l_b < m_qualBins; l_b++ )
+      std::cout << "    [" << std::setw( 10 ) << l_min + l_b * l_width << ", "
+                << std::setw( 10 ) << l_min + (l_b + 1) * l_width << ") "
+                << l_count[l_b] << "\n";
+    if( l_degenerate )
+      std::cout << "    degenerate " << l_degenerate << "\n";
+  }
 
-          //! Condition that P lies inside cyl defined by control pts A & B
-          if( l_c1 >= 0.0 && l_c2 >= 0.0 && l_d <= l_mat->m_radList[l_i] ) {
-            (l_mat->m_elemList).push_back( m_elemID );
+  std::cout << "\n";
+}
 
-            //! Safe to avoid further checking as particles are not intersecting
-            l_found = true;
-            break;
-          }
-        }
+//! ----------------------------------------------------------------------------
+//! Nodal groups, then element groups (matrix, piston, materials and bad
+//! elements) in output order
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::listGroups( std::vector< Eureka::DatGroup< I > > &o_groups ) const {
+  o_groups.clear();
+  for( size_t l_g = 0; l_g < m_nodeGroups.size(); l_g++ )
+    o_groups.push_back( { 7, m_nodeGroupDefs.name( l_g ), &m_nodeGroups[l_g] } );
+
+  o_groups.push_back( { 8, "matrix", &m_matrixList } );
+  o_groups.push_back( { 8, "Piston", &m_pistonList } );
+  for( size_t l_m = 0; l_m < m_matList.size(); l_m++ )
+    o_groups.push_back( { 8, m_matList[l_m]->m_name, &m_matElems[l_m] } );
+  if( m_badGroup )
+    o_groups.push_back( { 8, "bad_elems", &m_badList } );
+}
 
-        else if( l_mat->m_morph == geo::Morph::SPHERE ) {
-          //! Condition that P lies inside sph is if dist is less than radius
-          if( geo::dist( l_P, l_mat->m_sphCP[l_i] ) <= l_mat->m_radList[l_i] ) {
-            (l_mat->m_elemList).push_back( m_elemID );
+//! ----------------------------------------------------------------------------
+//! Split section of i_num lines into chunks (the first carries the header)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::addChunks( const std::string                         &i_header,
+                                        const typename Eureka::DatChunk< I >::Kind &i_kind,
+                                        const std::vector< I >                    *i_list,
+                                        const size_t                              &i_num,
+                                        std::vector< Eureka::DatChunk< I > >      &io_chunks ) const {
+  size_t l_beg = 0;
+
+  do {
+    size_t l_end = std::min( i_num, l_beg + Eureka::OUTCHUNKLINES );
+    io_chunks.push_back( Eureka::DatChunk< I >( l_beg ? std::string() : i_header, i_kind,
+                                                i_list, l_beg, l_end ) );
+    l_beg = l_end;
+  } while( l_beg < i_num );
+}
 
-            //! Safe to avoid further checking as particles are not intersecting
-            l_found = true;
-            break;
-          }
-        }
+//! ----------------------------------------------------------------------------
+//! Format chunk of dat file
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+void Eureka::Writer< I, R >::formatChunk( const Eureka::DatChunk< I > &i_chunk,
+                                          Eureka::OutBuffer           &o_buf ) const {
+  o_buf << i_chunk.m_header;
+
+  switch( i_chunk.m_kind ) {
+    //! Nodes (slots are in ID order)
+    case Eureka::DatChunk< I >::NODES:
+      for( size_t l_slot = i_chunk.m_beg; l_slot < i_chunk.m_end; l_slot++ ) {
+        if( !m_nodes.used( l_slot ) )
+          continue;
+
+        const geo::Vector &l_P = m_nodes.m_coords[l_slot];
+        o_buf << m_nodes.id( l_slot ) << ' ' << l_P.m_x << ' ' << l_P.m_y << ' '
+              << l_P.m_z << '\n';
       }
+      break;
 
-      //! Skip checking further materials as 1 element belongs in 1 material
-      if( l_found )
-        break;
-    }
-
-    //! If at this pt means elem lies inside matrix
-    if( !l_found )
-      m_matrixList.push_back( m_elemID );
+    //! Elements
+    case Eureka::DatChunk< I >::ELEMS:
+      for( size_t l_e = i_chunk.m_beg; l_e < i_chunk.m_end; l_e++ )
+        o_buf << l_e + 1 << ' '
+              << m_elems[l_e].m_node1 << ' ' << m_elems[l_e].m_node2 << ' '
+              << m_elems[l_e].m_node3 << ' ' << m_elems[l_e].m_node4
+              << '\n';
+      break;
 
-    //! Increment element ID
-    m_elemID++;
+    //! Group IDs
+    case Eureka::DatChunk< I >::GROUP:
+      for( size_t l_i = i_chunk.m_beg; l_i < i_chunk.m_end; l_i++ )
+        o_buf << (*i_chunk.m_list)[l_i] << '\n';
+      break;
   }
-
-  //! End time
-  l_time = clock() - l_time;
-  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
 }
 
 //! ----------------------------------------------------------------------------
-//! Write to dat file
+//! Format chunks in parallel and write them from offset i_offset on, at
+//! offsets following from the formatted sizes (a wave of chunks at a time to
+//! bound memory); returns the offset past the last chunk
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::writeDatFile() {
-  m_out << "3 4 " << m_numOfNodes << " " << m_elemMap.size() << std::endl;
+template< typename I, typename R >
+size_t Eureka::Writer< I, R >::writeChunks( const std::vector< Eureka::DatChunk< I > > &i_chunks,
+                                            const size_t                               &i_offset ) {
+  size_t l_wave = 4 * m_pool.size();
+  std::vector< Eureka::OutBuffer > l_bufs( l_wave );
+  std::vector< size_t > l_offsets( l_wave );
+  std::vector< char > l_ok( l_wave );
+  size_t l_offset = i_offset;
+
+  for( size_t l_first = 0; l_first < i_chunks.size(); l_first += l_wave ) {
+    size_t l_num = std::min( l_wave, i_chunks.size() - l_first );
+
+    m_pool.run( l_num, [&]( size_t i_c, unsigned int ) {
+      l_bufs[i_c].clear();
+      formatChunk( i_chunks[l_first + i_c], l_bufs[i_c] );
+    } );
+
+    //! Chunks follow each other
+    size_t l_waveBeg = l_offset;
+    for( size_t l_c = 0; l_c < l_num; l_c++ ) {
+      l_offsets[l_c] = l_offset;
+      l_offset += l_bufs[l_c].m_size;
+    }
 
-  //! Write nodes
-  writeNodes();
+    m_out.reserve( l_waveBeg, l_offset - l_waveBeg );
 
-  //! Write elems
-  writeElems();
+    m_pool.run( l_num, [&]( size_t i_c, unsigned int ) {
+      l_ok[i_c] = m_out.write( l_bufs[i_c], l_offsets[i_c] );
+    } );
 
-  //! Write nodal groups
-  writeNodalGroups();
+    if( std::find( l_ok.begin(), l_ok.begin() + l_num, 0 ) != l_ok.begin() + l_num ) {
+      std::cerr << "Couldn't write to " << m_outFile << "! Exiting..\n";
+      exit( EXIT_FAILURE );
+    }
+  }
 
-  //! Write element groups
-  writeElementGroups();
+  return l_offset;
 }
 
 //! ----------------------------------------------------------------------------
-//! Write nodes
+//! Write to dat file
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::writeNodes() {
+template< typename I, typename R >
+void Eureka::Writer< I, R >::writeDatFile() {
   //! Start time
   clock_t l_time = clock();
 
-  std::cout << "Writing nodes.. " << std::flush;
-  std::map< UID, geo::Vector >::iterator l_nodeIt;
+  std::cout << "Writing dat file.. " << std::flush;
+
+  std::vector< Eureka::DatChunk< I > > l_chunks;
 
-  //! Write nodes
-  for( l_nodeIt = m_nodeMap.begin(); l_nodeIt != m_nodeMap.end(); ++l_nodeIt )
-    m_out << l_nodeIt->first << " " << (l_nodeIt->second).m_x << " "
-          << (l_nodeIt->second).m_y << " " << (l_nodeIt->second).m_z << std::endl;
+  //! Header, nodes and elems
+  addChunks( "3 4 " + std::to_string( m_numOfNodes ) + " " +
+             std::to_string( m_elems.size() ) + "\n",
+             Eureka::DatChunk< I >::NODES, nullptr, m_nodes.size(), l_chunks );
+  addChunks( "", Eureka::DatChunk< I >::ELEMS, nullptr, m_elems.size(), l_chunks );
+
+  //! Nodal and element groups
+  std::vector< Eureka::DatGroup< I > > l_groups;
+  listGroups( l_groups );
+
+  for( size_t l_g = 0; l_g < l_groups.size(); l_g++ ) {
+    const std::vector< I > *l_list = l_groups[l_g].m_list;
+    addChunks( std::to_string( l_groups[l_g].m_code ) + " " + l_groups[l_g].m_name + " " +
+               std::to_string( l_list->size() ) + "\n",
+               Eureka::DatChunk< I >::GROUP, l_list, l_list->size(), l_chunks );
+  }
+
+  writeChunks( l_chunks );
 
   //! End time
   l_time = clock() - l_time;
@@ -546,21 +1120,120 @@ void Eureka::Writer::writeNodes() {
 }
 
 //! ----------------------------------------------------------------------------
-//! Write elements
+//! Write binary mesh (see EurekaBinary.h)
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::writeElems() {
+template< typename I, typename R >
+void Eureka::Writer< I, R >::writeBinFile() {
+  //! Elements and groups are written in place (widened from 32-bit indices)
+  static_assert( sizeof( Eureka::Elem< I > ) == 4 * sizeof( I ), "Unexpected element padding" );
+
   //! Start time
   clock_t l_time = clock();
 
-  std::cout << "Writing elems.. " << std::flush;
-  std::map< UID, Eureka::Elem >::iterator l_elemIt;
+  std::cout << "Writing binary file.. " << std::flush;
+
+  //! Pack IDs and coordinates of used slots
+  std::vector< uint64_t > l_ids;
+  std::vector< real >     l_coords;
+  l_ids.reserve( m_nodes.size() );
+  l_coords.reserve( 3 * m_nodes.size() );
+  for( size_t l_slot = 0; l_slot < m_nodes.size(); l_slot++ ) {
+    if( !m_nodes.used( l_slot ) )
+      continue;
+
+    const geo::Vector &l_P = m_nodes.m_coords[l_slot];
+    l_ids.push_back( m_nodes.id( l_slot ) );
+    l_coords.insert( l_coords.end(), { l_P.m_x, l_P.m_y, l_P.m_z } );
+  }
+
+  //! Section index, data of every section and whether it holds indices (of
+  //! type I) rather than 8-byte values
+  std::vector< Eureka::BinSection > l_index;
+  std::vector< const char * > l_data;
+  std::vector< bool > l_isIndex;
+
+  auto l_add = [&]( const std::string &i_name, const uint32_t &i_kind,
+                    const uint32_t &i_width, const uint64_t &i_count,
+                    const void *i_data, const bool &i_isIndex ) {
+    Eureka::BinSection l_sec;
+    memset( &l_sec, 0, sizeof( l_sec ) );
+    strncpy( l_sec.m_name, i_name.c_str(), Eureka::BIN_NAMELEN - 1 );
+    l_sec.m_kind  = i_kind;
+    l_sec.m_width = i_width;
+    l_sec.m_count = i_count;
+
+    l_index.push_back( l_sec );
+    l_data.push_back( static_cast< const char * >(i_data) );
+    l_isIndex.push_back( i_isIndex );
+  };
+
+  l_add( "node_ids",    Eureka::BIN_NODE_IDS,    1, l_ids.size(), l_ids.data(), false );
+  l_add( "node_coords", Eureka::BIN_NODE_COORDS, 3, l_ids.size(), l_coords.data(), false );
+  l_add( "elems",       Eureka::BIN_ELEMS,       4, m_elems.size(), m_elems.data(), true );
+
+  std::vector< Eureka::DatGroup< I > > l_groups;
+  listGroups( l_groups );
+  for( size_t l_g = 0; l_g < l_groups.size(); l_g++ )
+    l_add( l_groups[l_g].m_name,
+           (l_groups[l_g].m_code == 7) ? Eureka::BIN_NODAL_GROUP : Eureka::BIN_ELEM_GROUP,
+           1, l_groups[l_g].m_list->size(), l_groups[l_g].m_list->data(), true );
+
+  //! Sections follow the index
+  size_t l_offset = sizeof( Eureka::BinHeader ) +
+                    l_index.size() * sizeof( Eureka::BinSection );
+  for( size_t l_s = 0; l_s < l_index.size(); l_s++ ) {
+    l_index[l_s].m_offset = l_offset;
+    l_offset += 8 * l_index[l_s].m_width * l_index[l_s].m_count;
+  }
+
+  Eureka::BinHeader l_header;
+  memset( &l_header, 0, sizeof( l_header ) );
+  memcpy( l_header.m_magic, Eureka::BIN_MAGIC, 8 );
+  l_header.m_version     = Eureka::BIN_VERSION;
+  l_header.m_endian      = Eureka::BIN_ENDIAN;
+  l_header.m_numSections = l_index.size();
+  l_header.m_fileSize    = l_offset;
+
+  //! Pieces (data, size, offset, whether data holds indices) of at most
+  //! OUTBUFSIZE bytes (as written), written in parallel
+  std::vector< std::tuple< const char *, size_t, size_t, bool > > l_pieces;
+  l_pieces.push_back( std::make_tuple( reinterpret_cast< const char * >(&l_header),
+                                       sizeof( l_header ), 0, false ) );
+  l_pieces.push_back( std::make_tuple( reinterpret_cast< const char * >(l_index.data()),
+                                       l_index.size() * sizeof( Eureka::BinSection ),
+                                       sizeof( l_header ), false ) );
+
+  for( size_t l_s = 0; l_s < l_index.size(); l_s++ ) {
+    size_t l_size  = 8 * l_index[l_s].m_width * l_index[l_s].m_count;
+    size_t l_bytes = l_isIndex[l_s] ? sizeof( I ) : 8;
+    for( size_t l_beg = 0; l_beg < l_size; l_beg += Eureka::OUTBUFSIZE )
+      l_pieces.push_back( std::make_tuple( l_data[l_s] + l_beg / 8 * l_bytes,
+                                           std::min( Eureka::OUTBUFSIZE, l_size - l_beg ),
+                                           l_index[l_s].m_offset + l_beg, l_isIndex[l_s] ) );
+  }
+
+  m_out.reserve( 0, l_offset );
+
+  std::vector< char > l_ok( l_pieces.size() );
+  m_pool.run( l_pieces.size(), [&]( size_t i_p, unsigned int ) {
+    const char *l_piece = std::get< 0 >( l_pieces[i_p] );
+    size_t      l_size  = std::get< 1 >( l_pieces[i_p] );
+
+    //! Widen narrower indices to the stored 8 bytes
+    std::vector< uint64_t > l_wide;
+    if( std::get< 3 >( l_pieces[i_p] ) && sizeof( I ) != 8 ) {
+      const I *l_vals = reinterpret_cast< const I * >(l_piece);
+      l_wide.assign( l_vals, l_vals + l_size / 8 );
+      l_piece = reinterpret_cast< const char * >(l_wide.data());
+    }
+
+    l_ok[i_p] = m_out.write( l_piece, l_size, std::get< 2 >( l_pieces[i_p] ) );
+  } );
 
-  //! Write elems
-  for( l_elemIt = m_elemMap.begin(); l_elemIt != m_elemMap.end(); ++l_elemIt )
-    m_out << l_elemIt->first << " "
-          << (*l_elemIt).second.m_node1 << " " << (*l_elemIt).second.m_node2 << " "
-          << (*l_elemIt).second.m_node3 << " " << (*l_elemIt).second.m_node4
-          << std::endl;
+  if( std::find( l_ok.begin(), l_ok.end(), 0 ) != l_ok.end() ) {
+    std::cerr << "Couldn't write to " << m_outFile << "! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
 
   //! End time
   l_time = clock() - l_time;
@@ -568,155 +1241,296 @@ void Eureka::Writer::writeElems() {
 }
 
 //! ----------------------------------------------------------------------------
-//! Write nodal groups
+//! Partition elements and write one .dat file per part (<name>.<part>.dat)
+//! with local numbering, groups filtered to the part, nodes shared with every
+//! other part and global IDs of local nodes and elements
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::writeNodalGroups() {
+template< typename I, typename R >
+void Eureka::Writer< I, R >::writePartitions() {
+  if( m_numParts < 2 )
+    return;
+
   //! Start time
   clock_t l_time = clock();
 
-  std::cout << "Writing nodal groups.. " << std::flush;
-  std::vector< UID >::const_iterator l_it;
-
-  m_out << "7 top_nodes " << m_topNodes.size() << std::endl;
-  for( l_it = m_topNodes.begin(); l_it != m_topNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
-
-  m_out << "7 bottom_nodes " << m_bottomNodes.size() << std::endl;
-  for( l_it = m_bottomNodes.begin(); l_it != m_bottomNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  std::cout << "Partitioning into " << m_numParts << " parts.. " << std::flush;
 
-  m_out << "7 left_nodes " << m_leftNodes.size() << std::endl;
-  for( l_it = m_leftNodes.begin(); l_it != m_leftNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  size_t l_numElems = m_elems.size();
+  size_t l_numSlots = m_nodes.size();
+  size_t l_ranges   = 4 * m_pool.size();
 
-  m_out << "7 right_nodes " << m_rightNodes.size() << std::endl;
-  for( l_it = m_rightNodes.begin(); l_it != m_rightNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  //! Part of every element
+  std::vector< geo::Vector > l_centroids;
+  elemCentroids( l_centroids );
 
-  m_out << "7 front_nodes " << m_frontNodes.size() << std::endl;
-  for( l_it = m_frontNodes.begin(); l_it != m_frontNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  std::vector< unsigned int > l_part;
+  Eureka::rcbPartition( l_centroids, m_numParts, l_part );
 
-  m_out << "7 back_nodes " << m_backNodes.size() << std::endl;
-  for( l_it = m_backNodes.begin(); l_it != m_backNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  //! Node slots of every element
+  std::vector< UID > l_tets( 4 * l_numElems );
+  std::vector< UID > l_missing( l_ranges, Eureka::NodeTable< I, R >::NONE );
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_e = i_r * l_numElems / l_ranges; l_e < (i_r + 1) * l_numElems / l_ranges; l_e++ ) {
+      size_t l_s[4];
+      if( !elemSlots( m_elems[l_e], l_s, l_missing[i_r] ) )
+        return;
 
-  m_out << "7 corner_nodes " << m_cornerNodes.size() << std::endl;
-  for( l_it = m_cornerNodes.begin(); l_it != m_cornerNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+      for( int l_k = 0; l_k < 4; l_k++ )
+        l_tets[4 * l_e + l_k] = l_s[l_k];
+    }
+  } );
+  checkMissing( l_missing );
 
-  m_out << "7 top_corner_nodes " << m_topCornerNodes.size() << std::endl;
-  for( l_it = m_topCornerNodes.begin(); l_it != m_topCornerNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  Eureka::Graph l_dual;
+  l_dual.buildDual( l_numSlots, l_tets, m_pool );
+  UID l_cut = Eureka::cutFaces( l_dual, l_part ), l_refinedCut = l_cut;
 
-  m_out << "7 zleft_nodes " << m_zLeftNodes.size() << std::endl;
-  for( l_it = m_zLeftNodes.begin(); l_it != m_zLeftNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  if( m_partRefine ) {
+    Eureka::refinePartition( l_dual, m_numParts, l_part );
+    l_refinedCut = Eureka::cutFaces( l_dual, l_part );
+  }
 
-  m_out << "7 zright_nodes " << m_zRightNodes.size() << std::endl;
-  for( l_it = m_zRightNodes.begin(); l_it != m_zRightNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  //! Elements of every part (in ID order)
+  std::vector< UID > l_elemOff( m_numParts + 1, 0 ), l_partElems( l_numElems );
+  for( size_t l_e = 0; l_e < l_numElems; l_e++ )
+    l_elemOff[l_part[l_e] + 1]++;
+  for( unsigned int l_p = 0; l_p < m_numParts; l_p++ )
+    l_elemOff[l_p + 1] += l_elemOff[l_p];
+
+  std::vector< UID > l_next( l_elemOff.begin(), l_elemOff.end() - 1 );
+  for( size_t l_e = 0; l_e < l_numElems; l_e++ )
+    l_partElems[l_next[l_part[l_e]]++] = l_e;
+
+  //! Node slots of every part (in ID order): sorted unique (part, slot) keys
+  std::vector< uint64_t > l_keys( l_tets.size() );
+  std::vector< UID > l_vals( l_tets.size() );
+  m_pool.run( l_ranges, [&]( size_t i_r, unsigned int ) {
+    for( size_t l_i = i_r * l_tets.size() / l_ranges; l_i < (i_r + 1) * l_tets.size() / l_ranges; l_i++ ) {
+      l_keys[l_i] = l_part[l_i / 4] * (uint64_t) l_numSlots + l_tets[l_i];
+      l_vals[l_i] = l_i;
+    }
+  } );
 
-  m_out << "7 yleft_nodes " << m_yLeftNodes.size() << std::endl;
-  for( l_it = m_yLeftNodes.begin(); l_it != m_yLeftNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  Eureka::radixSort( l_keys, l_vals, m_pool );
+  l_keys.erase( std::unique( l_keys.begin(), l_keys.end() ), l_keys.end() );
 
-  m_out << "7 yright_nodes " << m_yRightNodes.size() << std::endl;
-  for( l_it = m_yRightNodes.begin(); l_it != m_yRightNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  std::vector< UID > l_nodeOff( m_numParts + 1, 0 ), l_partSlots( l_keys.size() );
+  for( size_t l_i = 0; l_i < l_keys.size(); l_i++ ) {
+    l_nodeOff[l_keys[l_i] / l_numSlots + 1]++;
+    l_partSlots[l_i] = l_keys[l_i] % l_numSlots;
+  }
+  for( unsigned int l_p = 0; l_p < m_numParts; l_p++ )
+    l_nodeOff[l_p + 1] += l_nodeOff[l_p];
+
+  //! Parts of every node slot (in part order)
+  std::vector< UID > l_slotOff( l_numSlots + 1, 0 );
+  std::vector< unsigned int > l_slotParts( l_keys.size() );
+  for( size_t l_i = 0; l_i < l_keys.size(); l_i++ )
+    l_slotOff[l_partSlots[l_i] + 1]++;
+  for( size_t l_s = 0; l_s < l_numSlots; l_s++ )
+    l_slotOff[l_s + 1] += l_slotOff[l_s];
+
+  l_next.assign( l_slotOff.begin(), l_slotOff.end() - 1 );
+  for( size_t l_i = 0; l_i < l_keys.size(); l_i++ )
+    l_slotParts[l_next[l_partSlots[l_i]]++] = l_keys[l_i] / l_numSlots;
+
+  //! File of every part (output file without .dat/.ebm extension)
+  std::string l_stem = m_outFile;
+  size_t l_len = l_stem.size();
+  if( l_len >= 4 && (l_stem.compare( l_len - 4, 4, ".dat" ) == 0 ||
+                     l_stem.compare( l_len - 4, 4, ".ebm" ) == 0) )
+    l_stem.resize( l_len - 4 );
+
+  std::vector< Eureka::DatGroup< I > > l_groups;
+  listGroups( l_groups );
+
+  std::vector< char > l_ok( m_numParts );
+  m_pool.run( m_numParts, [&]( size_t i_p, unsigned int ) {
+    std::string l_file = l_stem + "." + std::to_string( i_p ) + ".dat";
+
+    std::vector< UID >::const_iterator l_slotBeg = l_partSlots.begin() + l_nodeOff[i_p];
+    std::vector< UID >::const_iterator l_slotEnd = l_partSlots.begin() + l_nodeOff[i_p + 1];
+    std::vector< UID >::const_iterator l_elemBeg = l_partElems.begin() + l_elemOff[i_p];
+    std::vector< UID >::const_iterator l_elemEnd = l_partElems.begin() + l_elemOff[i_p + 1];
+
+    //! Local ID of node slot (0 if not in part)
+    auto l_localNode = [&]( const size_t &i_slot ) {
+      std::vector< UID >::const_iterator l_it = std::lower_bound( l_slotBeg, l_slotEnd, i_slot );
+      return (l_it != l_slotEnd && *l_it == i_slot) ? (UID) (l_it - l_slotBeg + 1) : 0;
+    };
+
+    Eureka::OutFile l_out;
+    Eureka::OutBuffer l_buf;
+    size_t l_offset = 0;
+    l_ok[i_p] = l_out.open( l_file.c_str() );
+
+    //! Write out buffer when full (or at the end)
+    auto l_flush = [&]( const bool &i_last ) {
+      if( !i_last && l_buf.m_size < Eureka::OUTBUFSIZE )
+        return;
+
+      l_ok[i_p] = l_ok[i_p] && l_out.write( l_buf, l_offset );
+      l_offset += l_buf.m_size;
+      l_buf.clear();
+    };
+
+    auto l_list = [&]( const int &i_code, const std::string &i_name,
+                       const std::vector< UID > &i_ids ) {
+      l_buf << std::to_string( i_code ) << ' ' << i_name << ' ' << (UID) i_ids.size() << '\n';
+      for( size_t l_i = 0; l_i < i_ids.size(); l_i++ ) {
+        l_buf << i_ids[l_i] << '\n';
+        l_flush( false );
+      }
+    };
+
+    //! Header and nodes
+    l_buf << "3 4 " << (UID) (l_slotEnd - l_slotBeg) << ' ' << (UID) (l_elemEnd - l_elemBeg) << '\n';
+    for( std::vector< UID >::const_iterator l_it = l_slotBeg; l_it != l_slotEnd; ++l_it ) {
+      const geo::Vector &l_P = m_nodes.m_coords[*l_it];
+      l_buf << (UID) (l_it - l_slotBeg + 1) << ' ' << l_P.m_x << ' ' << l_P.m_y << ' '
+            << l_P.m_z << '\n';
+      l_flush( false );
+    }
 
-  m_out << "7 xfront_nodes " << m_xFrontNodes.size() << std::endl;
-  for( l_it = m_xFrontNodes.begin(); l_it != m_xFrontNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+    //! Elements
+    for( std::vector< UID >::const_iterator l_it = l_elemBeg; l_it != l_elemEnd; ++l_it ) {
+      l_buf << (UID) (l_it - l_elemBeg + 1);
+      for( int l_k = 0; l_k < 4; l_k++ )
+        l_buf << ' ' << l_localNode( l_tets[4 * *l_it + l_k] );
+      l_buf << '\n';
+      l_flush( false );
+    }
 
-  m_out << "7 xback_nodes " << m_xBackNodes.size() << std::endl;
-  for( l_it = m_xBackNodes.begin(); l_it != m_xBackNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+    //! Groups filtered to the part
+    std::vector< UID > l_ids;
+    for( size_t l_g = 0; l_g < l_groups.size(); l_g++ ) {
+      const std::vector< I > &l_global = *l_groups[l_g].m_list;
+
+      l_ids.clear();
+      for( size_t l_i = 0; l_i < l_global.size(); l_i++ ) {
+        if( l_groups[l_g].m_code == 7 ) {
+          UID l_local = l_localNode( m_nodes.find( l_global[l_i] ) );
+          if( l_local )
+            l_ids.push_back( l_local );
+        }
+        else if( l_part[l_global[l_i] - 1] == i_p )
+          l_ids.push_back( std::lower_bound( l_elemBeg, l_elemEnd, l_global[l_i] - 1 ) -
+                           l_elemBeg + 1 );
+      }
 
-  m_out << "7 matrix_nodes " << m_matrixNodes.size() << std::endl;
-  for( l_it = m_matrixNodes.begin(); l_it != m_matrixNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+      l_list( l_groups[l_g].m_code, l_groups[l_g].m_name, l_ids );
+    }
 
-  m_out << "7 piston_nodes " << m_pistonNodes.size() << std::endl;
-  for( l_it = m_pistonNodes.begin(); l_it != m_pistonNodes.end(); ++l_it )
-    m_out << *l_it << std::endl;
+    //! Nodes shared with every other part (in ID order, so that the lists of
+    //! both parts match)
+    std::vector< std::vector< UID > > l_shared( m_numParts );
+    for( std::vector< UID >::const_iterator l_it = l_slotBeg; l_it != l_slotEnd; ++l_it )
+      for( UID l_i = l_slotOff[*l_it]; l_i < l_slotOff[*l_it + 1]; l_i++ )
+        if( l_slotParts[l_i] != i_p )
+          l_shared[l_slotParts[l_i]].push_back( l_it - l_slotBeg + 1 );
+
+    for( unsigned int l_q = 0; l_q < m_numParts; l_q++ )
+      if( !l_shared[l_q].empty() )
+        l_list( 7, "shared_" + std::to_string( l_q ), l_shared[l_q] );
+
+    //! Global IDs of local nodes and elements
+    l_ids.clear();
+    for( std::vector< UID >::const_iterator l_it = l_slotBeg; l_it != l_slotEnd; ++l_it )
+      l_ids.push_back( m_nodes.id( *l_it ) );
+    l_list( 9, "global_nodes", l_ids );
+
+    l_ids.clear();
+    for( std::vector< UID >::const_iterator l_it = l_elemBeg; l_it != l_elemEnd; ++l_it )
+      l_ids.push_back( *l_it + 1 );
+    l_list( 9, "global_elems", l_ids );
+
+    l_flush( true );
+    l_out.close();
+  } );
+
+  for( unsigned int l_p = 0; l_p < m_numParts; l_p++ )
+    if( !l_ok[l_p] ) {
+      std::cerr << "Couldn't write to " << l_stem << "." << l_p << ".dat! Exiting..\n";
+      exit( EXIT_FAILURE );
+    }
 
   //! End time
   l_time = clock() - l_time;
   std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+
+  std::cout << "Cut faces = " << l_cut;
+  if( m_partRefine )
+    std::cout << " -> " << l_refinedCut << " (refined)";
+  std::cout << "\n";
 }
 
 //! ----------------------------------------------------------------------------
-//! Write element groups
+//! Split config line into name and value (returns false for blank lines,
+//! comments and entries without values)
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::writeElementGroups() {
-  //! Start time
-  clock_t l_time = clock();
+static bool confEntry( const std::string &i_lineBuf,
+                       std::string       &o_varName,
+                       std::string       &o_varValue ) {
+  size_t l_k = -1, l_l;
 
-  std::cout << "Writing element groups.. " << std::flush;
+  while( (++l_k < i_lineBuf.length()) && (i_lineBuf[l_k] == ' ') );
 
-  std::vector< UID >::const_iterator        l_it;
-  std::vector< Material * >::const_iterator l_matIt;
+  if( (l_k >= i_lineBuf.length()) || (i_lineBuf[l_k] == '#') )
+    return false;
 
-  //! Matrix
-  m_out << "8 matrix " << m_matrixList.size() << std::endl;
-  for( l_it = m_matrixList.begin(); l_it != m_matrixList.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  l_l = l_k - 1;
 
-  //! Piston
-  m_out << "8 Piston " << m_pistonList.size() << std::endl;
-  for( l_it = m_pistonList.begin(); l_it != m_pistonList.end(); ++l_it )
-    m_out << *l_it << std::endl;
+  while( (++l_l < i_lineBuf.length()) && (i_lineBuf[l_l] != '=') );
 
-  //! Materials
-  for( l_matIt = m_matList.begin(); l_matIt != m_matList.end(); ++l_matIt ) {
-    Eureka::Material *l_mat = *l_matIt;
-    m_out << "8 " << l_mat->m_name << " " << l_mat->m_elemList.size() << "\n";
+  if( l_l >= i_lineBuf.length() )
+    return false;
 
-    for( l_it = (l_mat->m_elemList).begin(); l_it != (l_mat->m_elemList).end();
-                                                                        ++l_it )
-      m_out << *l_it << std::endl;
-  }
+  o_varName  = i_lineBuf.substr( l_k, l_l - l_k );
+  o_varValue = i_lineBuf.substr( l_l + 1 );
 
-  //! End time
-  l_time = clock() - l_time;
-  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+  return !o_varValue.empty();
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse config value as a whole integer in [i_min, i_max] (returns false if
+//! malformed or out of range)
+//! ----------------------------------------------------------------------------
+static bool confInt( const std::string &i_varValue,
+                     long               i_min,
+                     long               i_max,
+                     long              &o_int ) {
+  const char *l_str = i_varValue.c_str();
+  char *l_end;
+
+  errno = 0;
+  o_int = std::strtol( l_str, &l_end, 10 );
+
+  //! Trailing blanks (and carriage returns) are fine, anything else is not
+  while( std::isspace( (unsigned char) *l_end ) )
+    l_end++;
+
+  return (l_end != l_str) && (*l_end == '\0') && (errno != ERANGE) &&
+         (o_int >= i_min) && (o_int <= i_max);
 }
 
 //! ----------------------------------------------------------------------------
 //! Config file parser
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::parseConfigFile( const char *i_filename ) {
+void Eureka::WriterBase::parseConfigFile( const char *i_filename ) {
   std::ifstream l_confFn( i_filename, std::ios::in );
   if( !l_confFn.is_open() ) {
     std::cerr << "Cannot open " << i_filename << "! Exiting..\n";
-    m_inMsh.close();
     m_out.close();
     exit( EXIT_FAILURE );
   }
 
-  std::string l_lineBuf;
-
-  while( getline( l_confFn, l_lineBuf ) ) {
-    size_t l_k = -1, l_l;
-
-    while( (++l_k < l_lineBuf.length()) && (l_lineBuf[l_k] == ' ') );
-
-    if( (l_k >= l_lineBuf.length()) || (l_lineBuf[l_k] == '#') )
-      continue;
-
-    l_l = l_k - 1;
+  std::string l_lineBuf, l_varName, l_varValue;
 
-    while( (++l_l < l_lineBuf.length()) && (l_lineBuf[l_l] != '=') );
+  //! Whether nodal groups are defined (else the default ones are written)
+  bool l_nodeGroups = false;
 
-    if( l_l >= l_lineBuf.length() )
-      continue;
-
-    std::string l_varName  = l_lineBuf.substr( l_k, l_l - l_k );
-    std::string l_varValue = l_lineBuf.substr( l_l + 1 );
-
-    //! Skip entries without values
-    if( l_varValue.empty() )
+  while( getline( l_confFn, l_lineBuf ) ) {
+    if( !confEntry( l_lineBuf, l_varName, l_varValue ) )
       continue;
 
     //! Box
@@ -728,25 +1542,466 @@ void Eureka::Writer::parseConfigFile( const char *i_filename ) {
       m_height      = StrToReal( l_varValue );
     else if( l_varName == "piston_thicc" )
       m_pistonThicc = StrToReal( l_varValue );
+
+    //! Particle voxel labels
+    else if( l_varName == "label_resolution" ) {
+      if( l_varValue == "auto" )
+        m_labelRes  = Eureka::LABELAUTO;
+      else if( !confInt( l_varValue, 0, Eureka::LABELMAXRES, m_labelRes ) ) {
+        std::cerr << "Invalid label resolution (" << l_varValue << "), expected auto or 0 to "
+                  << Eureka::LABELMAXRES << "! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+    }
+
+    //! Element quality
+    else if( l_varName == "quality_metric" ) {
+      if( !m_qual.setMetric( l_varValue ) ) {
+        std::cerr << "Unknown quality metric (" << l_varValue << ")! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+    }
+    else if( l_varName == "quality_threshold" )
+      m_qual.setThreshold( StrToReal( l_varValue ) );
+    else if( l_varName == "quality_bins" ) {
+      long l_bins;
+      if( !confInt( l_varValue, 1, Eureka::QUALMAXBINS, l_bins ) ) {
+        std::cerr << "Invalid number of quality bins (" << l_varValue
+                  << "), expected 1 to " << Eureka::QUALMAXBINS << "! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+      m_qualBins    = (int) l_bins;
+    }
+    else if( l_varName == "bad_elems_group" )
+      m_badGroup    = (l_varValue == "yes" || l_varValue == "1");
+
+    //! Renumbering
+    else if( l_varName == "node_order" ) {
+      if( !Eureka::parseOrdering( l_varValue, m_nodeOrder ) ) {
+        std::cerr << "Unknown node order (" << l_varValue << ")! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+    }
+    else if( l_varName == "elem_order" ) {
+      //! Elements have no graph to order by
+      if( !Eureka::parseOrdering( l_varValue, m_elemOrder ) ||
+          m_elemOrder == Eureka::Ordering::RCM ) {
+        std::cerr << "Unknown element order (" << l_varValue << ")! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+    }
+
+    //! Nodal groups (none: no nodal groups, defaults: the default ones)
+    else if( l_varName == "node_group" ) {
+      l_nodeGroups = true;
+      if( l_varValue == "defaults" )
+        m_nodeGroupDefs.addDefaults();
+      else if( l_varValue != "none" && !m_nodeGroupDefs.add( l_varValue ) ) {
+        std::cerr << "Malformed node group (" << l_varValue << ")! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+    }
+    else if( l_varName == "node_tolerance" )
+      m_nodeTol     = StrToReal( l_varValue );
+
+    //! Partitioning
+    else if( l_varName == "partitions" ) {
+      //! Upper bound (the number of elements) is checked once they are read
+      long l_parts;
+      if( !confInt( l_varValue, 1, std::numeric_limits< unsigned int >::max(), l_parts ) ) {
+        std::cerr << "Invalid number of partitions (" << l_varValue << ")! Exiting..\n";
+        m_out.close();
+        exit( EXIT_FAILURE );
+      }
+      m_numParts    = (unsigned int) l_parts;
+    }
+    else if( l_varName == "partition_refine" )
+      m_partRefine  = (l_varValue == "yes" || l_varValue == "1");
+
+    //! Streaming
+    else if( l_varName == "streaming" )
+      m_stream      = (l_varValue == "yes" || l_varValue == "1");
+    else if( l_varName == "spill_dir" )
+      m_spillDir    = l_varValue;
   }
 
   l_confFn.close();
 
+  if( !l_nodeGroups )
+    m_nodeGroupDefs.addDefaults();
+
   parseMaterials();
 }
 
 //! ----------------------------------------------------------------------------
-//! Read msh file and write to dat file
+//! Choose index width and coordinate precision from the config file
+//! (index_width = auto/32/64, coord_precision = double/float); auto width
+//! follows from the largest node ID or number of elements the msh headers
+//! tell (i_maxIndex), o_autoIndex says whether it was picked that way
 //! ----------------------------------------------------------------------------
-void Eureka::Writer::readMshWriteDat() {
+void Eureka::selectTypes( const char *i_confFile,
+                          const UID  &i_maxIndex,
+                          bool       &o_wideIndex,
+                          bool       &o_autoIndex,
+                          bool       &o_singleCoords ) {
+  std::string l_width = "auto", l_precision = "double";
+
+  //! Missing config file is reported by the parser
+  std::ifstream l_confFn( i_confFile, std::ios::in );
+  std::string l_lineBuf, l_varName, l_varValue;
+
+  while( getline( l_confFn, l_lineBuf ) ) {
+    if( !confEntry( l_lineBuf, l_varName, l_varValue ) )
+      continue;
+
+    if( l_varName == "index_width" )
+      l_width     = l_varValue;
+    else if( l_varName == "coord_precision" )
+      l_precision = l_varValue;
+  }
+
+  l_confFn.close();
+
+  if( l_precision != "double" && l_precision != "float" ) {
+    std::cerr << "Unknown coordinate precision (" << l_precision << ")! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+  o_singleCoords = (l_precision == "float");
+  o_autoIndex    = (l_width == "auto");
+
+  if( l_width == "32" )
+    o_wideIndex = false;
+  else if( l_width == "64" )
+    o_wideIndex = true;
+
+  //! Largest node ID and number of elements must fit 32 bits
+  else if( o_autoIndex )
+    o_wideIndex = (i_maxIndex > std::numeric_limits< uint32_t >::max());
+  else {
+    std::cerr << "Unknown index width (" << l_width << ")! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  std::cout << "Using " << (o_wideIndex ? 64 : 32) << "-bit indices and " << l_precision
+            << " coordinates\n";
+}
+
+//! ----------------------------------------------------------------------------
+//! Read msh file and write dat file in bounded memory: only the nodes are
+//! kept, elements are classified and written a few blocks at a time, element
+//! lines and the IDs of nodal and element groups are spilled to temporary
+//! files and copied into place at the end (returns false if node IDs exceed
+//! the index type)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+bool Eureka::Writer< I, R >::streamMshWriteDat() {
+  size_t l_len = m_outFile.size();
+  if( l_len >= 4 && m_outFile.compare( l_len - 4, 4, ".ebm" ) == 0 ) {
+    std::cerr << "Streaming writes .dat files only! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  if( m_nodeOrder != Eureka::Ordering::NONE || m_elemOrder != Eureka::Ordering::NONE ||
+      m_numParts > 1 || m_qualBins > 0 )
+    std::cout << "Orderings, partitions and quality histograms need the whole mesh, "
+              << "ignored when streaming\n";
+
+  //! Read Nodes
+  if( !readNodes() )
+    return false;
+
+  //! Start time
+  clock_t l_time = clock();
+
+  std::cout << "Streaming elems.. " << std::flush;
+
+  findSection( "$Elements" );
+
+  std::vector< Eureka::MshBlock > l_blocks;
+  splitElems( l_blocks );
+
+  std::vector< std::vector< I > * > l_groups;
+  elemGroups( l_groups );
+
+  //! Spill files of elements and groups, by list the group would be kept in
+  std::string l_dir = m_spillDir;
+  if( l_dir.empty() ) {
+    size_t l_slash = m_outFile.rfind( '/' );
+    l_dir = (l_slash == std::string::npos) ? std::string( "." ) : m_outFile.substr( 0, l_slash );
+  }
+
+  std::vector< const std::vector< I > * > l_spilled( l_groups.begin(), l_groups.end() );
+  l_spilled.push_back( &m_badList );
+
+  //! Nodal groups stay empty, their IDs go to spill files only
+  size_t l_numNodeGroups = m_nodeGroupDefs.size();
+  m_nodeGroups.assign( l_numNodeGroups, std::vector< I >() );
+  for( size_t l_g = 0; l_g < l_numNodeGroups; l_g++ )
+    l_spilled.push_back( &m_nodeGroups[l_g] );
+
+  Eureka::SpillFile l_elemSpill;
+  std::vector< Eureka::SpillFile > l_spills( l_spilled.size() );
+  bool l_ok = l_elemSpill.open( l_dir );
+  for( size_t l_g = 0; l_g < l_spills.size(); l_g++ )
+    l_ok = l_ok && l_spills[l_g].open( l_dir );
+
+  if( !l_ok ) {
+    std::cerr << "Couldn't create spill files in " << l_dir << "! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  //! Append IDs to spill file
+  Eureka::OutBuffer l_buf;
+  auto l_spill = [&]( Eureka::SpillFile &io_spill, const std::vector< I > &i_ids ) {
+    l_buf.clear();
+    for( size_t l_i = 0; l_i < i_ids.size(); l_i++ )
+      l_buf << i_ids[l_i] << '\n';
+
+    if( !io_spill.append( l_buf, i_ids.size() ) ) {
+      std::cerr << "Couldn't write spill file in " << l_dir << "! Exiting..\n";
+      exit( EXIT_FAILURE );
+    }
+  };
+
+  //! Per block of a wave: connectivity and quality, element lines, groups,
+  //! bad elements and missing node
+  size_t l_wave = m_pool.size();
+  std::vector< std::vector< Eureka::Elem< I > > > l_elems( l_wave );
+  std::vector< std::vector< float > > l_qual( l_wave );
+  std::vector< Eureka::OutBuffer > l_lines( l_wave );
+  std::vector< std::vector< std::vector< I > > > l_lists( l_wave,
+                                      std::vector< std::vector< I > >( l_groups.size() ) );
+  std::vector< std::vector< I > > l_bad( l_wave );
+  std::vector< const UID * > l_missing( l_wave );
+  std::vector< UID > l_firstID( l_wave + 1 );
+
+  //! Nodes (by slot) of matrix tets
+  std::vector< std::atomic< bool > > l_inMatrix( m_nodes.size() );
+
+  for( size_t l_first = 0; l_first < l_blocks.size(); l_first += l_wave ) {
+    size_t l_num = std::min( l_wave, l_blocks.size() - l_first );
+
+    m_pool.run( l_num, [&]( size_t i_b, unsigned int ) {
+      parseElems( l_blocks[l_first + i_b] );
+    } );
+
+    for( size_t l_b = 0; l_b < l_num; l_b++ )
+      if( l_blocks[l_first + l_b].m_errPos )
+        mshError( "element", l_blocks[l_first + l_b].m_errPos );
+
+    buildGrid( l_blocks, l_first, l_num );
+
+    //! Mark box faces of nodes on tagged triangles
+    l_firstID[0] = m_elemID;
+    for( size_t l_b = 0; l_b < l_num; l_b++ ) {
+      const Eureka::MshBlock &l_block = l_blocks[l_first + l_b];
+      std::vector< std::pair< UID, unsigned char > >::const_iterator l_faceIt;
+      for( l_faceIt = l_block.m_faceNodes.begin(); l_faceIt != l_block.m_faceNodes.end();
+           ++l_faceIt )
+        m_nodePreds[nodeSlot( l_faceIt->first )] |= l_faceIt->second;
+
+      l_firstID[l_b + 1] = l_firstID[l_b] + l_block.m_tets.size() / 5;
+    }
+
+    //! Classify, check quality and format element lines in parallel
+    m_pool.run( l_num, [&]( size_t i_b, unsigned int ) {
+      UID l_numTets = l_firstID[i_b + 1] - l_firstID[i_b];
+      l_elems[i_b].resize( l_numTets );
+      l_qual[i_b].resize( l_numTets );
+      for( size_t l_g = 0; l_g < l_groups.size(); l_g++ )
+        l_lists[i_b][l_g].clear();
+      l_bad[i_b].clear();
+      l_missing[i_b] = nullptr;
+
+      classifyElems( l_blocks[l_first + i_b], l_firstID[i_b], l_elems[i_b].data(),
+                     l_qual[i_b].data(), l_lists[i_b], l_bad[i_b], l_inMatrix,
+                     l_missing[i_b] );
+      if( l_missing[i_b] )
+        return;
+
+      l_lines[i_b].clear();
+      for( UID l_t = 0; l_t < l_numTets; l_t++ )
+        l_lines[i_b] << l_firstID[i_b] + l_t << ' '
+                     << l_elems[i_b][l_t].m_node1 << ' ' << l_elems[i_b][l_t].m_node2 << ' '
+                     << l_elems[i_b][l_t].m_node3 << ' ' << l_elems[i_b][l_t].m_node4
+                     << '\n';
+    } );
+
+    //! First missing node in file order
+    for( size_t l_b = 0; l_b < l_num; l_b++ )
+      if( l_missing[l_b] )
+        nodeSlot( *l_missing[l_b] );
+
+    //! Spill in element ID order
+    for( size_t l_b = 0; l_b < l_num; l_b++ ) {
+      if( !l_elemSpill.append( l_lines[l_b], l_firstID[l_b + 1] - l_firstID[l_b] ) ) {
+        std::cerr << "Couldn't write spill file in " << l_dir << "! Exiting..\n";
+        exit( EXIT_FAILURE );
+      }
+
+      for( size_t l_g = 0; l_g < l_groups.size(); l_g++ )
+        l_spill( l_spills[l_g], l_lists[l_b][l_g] );
+      l_spill( l_spills[l_groups.size()], l_bad[l_b] );
+
+      l_blocks[l_first + l_b] = Eureka::MshBlock();
+    }
+
+    m_elemID = l_firstID[l_num];
+  }
+
+  markMatrixNodes( l_inMatrix );
+
+  //! End time
+  l_time = clock() - l_time;
+  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+
+  printGrid();
+
+  //! Spill nodal groups a wave of slot ranges at a time, in ID order
+  std::vector< std::vector< unsigned int > > l_groupsOf;
+  nodeGroupsOf( l_groupsOf );
+
+  size_t l_numSlots = m_nodePreds.size();
+  size_t l_firstNodeSpill = l_groups.size() + 1;
+  std::vector< std::vector< std::vector< I > > > l_nodeLists( l_wave,
+                                      std::vector< std::vector< I > >( l_numNodeGroups ) );
+
+  for( size_t l_beg = 0; l_beg < l_numSlots; l_beg += l_wave * Eureka::OUTCHUNKLINES ) {
+    m_pool.run( l_wave, [&]( size_t i_r, unsigned int ) {
+      size_t l_s0 = std::min( l_numSlots, l_beg + i_r * Eureka::OUTCHUNKLINES );
+      size_t l_s1 = std::min( l_numSlots, l_s0 + Eureka::OUTCHUNKLINES );
+
+      for( size_t l_g = 0; l_g < l_numNodeGroups; l_g++ )
+        l_nodeLists[i_r][l_g].clear();
+
+      for( size_t l_s = l_s0; l_s < l_s1; l_s++ )
+        if( m_nodes.used( l_s ) ) {
+          const std::vector< unsigned int > &l_of = l_groupsOf[m_nodePreds[l_s]];
+          for( size_t l_k = 0; l_k < l_of.size(); l_k++ )
+            l_nodeLists[i_r][l_of[l_k]].push_back( m_nodes.id( l_s ) );
+        }
+    } );
+
+    for( size_t l_r = 0; l_r < l_wave; l_r++ )
+      for( size_t l_g = 0; l_g < l_numNodeGroups; l_g++ )
+        l_spill( l_spills[l_firstNodeSpill + l_g], l_nodeLists[l_r][l_g] );
+  }
+
+  std::cout << "Number of bad elems = " << l_spills[l_groups.size()].lines() << "\n\n";
+
+  //! Write dat file: header and nodes, then spilled elements, then every
+  //! group either formatted or copied from its spill file
+  l_time = clock();
+
+  std::cout << "Writing dat file.. " << std::flush;
+
+  std::vector< Eureka::DatChunk< I > > l_chunks;
+  addChunks( "3 4 " + std::to_string( m_numOfNodes ) + " " +
+             std::to_string( l_elemSpill.lines() ) + "\n",
+             Eureka::DatChunk< I >::NODES, nullptr, m_nodes.size(), l_chunks );
+  size_t l_offset = writeChunks( l_chunks );
+
+  l_ok = l_elemSpill.copyTo( m_out, l_offset );
+  l_offset += l_elemSpill.size();
+
+  std::vector< Eureka::DatGroup< I > > l_datGroups;
+  listGroups( l_datGroups );
+
+  for( size_t l_g = 0; l_g < l_datGroups.size() && l_ok; l_g++ ) {
+    const std::vector< I > *l_list = l_datGroups[l_g].m_list;
+    size_t l_s = std::find( l_spilled.begin(), l_spilled.end(), l_list ) - l_spilled.begin();
+    std::string l_header = std::to_string( l_datGroups[l_g].m_code ) + " " +
+                           l_datGroups[l_g].m_name + " ";
+
+    if( l_s == l_spilled.size() ) {
+      l_chunks.clear();
+      addChunks( l_header + std::to_string( l_list->size() ) + "\n",
+                 Eureka::DatChunk< I >::GROUP, l_list, l_list->size(), l_chunks );
+      l_offset = writeChunks( l_chunks, l_offset );
+      continue;
+    }
+
+    l_buf.clear();
+    l_buf << l_header << l_spills[l_s].lines() << '\n';
+    l_ok = m_out.write( l_buf, l_offset ) && l_spills[l_s].copyTo( m_out, l_offset + l_buf.m_size );
+    l_offset += l_buf.m_size + l_spills[l_s].size();
+  }
+
+  if( !l_ok ) {
+    std::cerr << "Couldn't write to " << m_outFile << "! Exiting..\n";
+    exit( EXIT_FAILURE );
+  }
+
+  //! End time
+  l_time = clock() - l_time;
+  std::cout << "Done! (" << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Read msh file and write to dat file (returns false, having written
+//! nothing, if node IDs exceed the index type)
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+bool Eureka::Writer< I, R >::readMshWriteDat() {
+  //! Bounded memory mode
+  if( m_stream )
+    return streamMshWriteDat();
+
   //! Read Nodes
-  readNodes();
+  if( !readNodes() )
+    return false;
 
   //! Read elems
   readElems();
 
-  std::cout << "Number of bad elems = " << m_badElems << "\n\n";
+  //! Every part needs at least one element
+  if( m_numParts > m_elems.size() ) {
+    std::cerr << "Cannot partition " << m_elems.size() << " elements into "
+              << m_numParts << " parts! Exiting..\n";
+    m_out.close();
+    exit( EXIT_FAILURE );
+  }
+
+  //! Build nodal groups
+  buildNodalGroups();
+
+  std::cout << "Number of bad elems = " << m_badList.size() << "\n\n";
+
+  //! Quality histograms
+  printQuality();
+
+  //! Renumber elements and nodes
+  renumberElems();
+  renumberNodes();
+
+  //! Write binary (.ebm) or dat file
+  size_t l_len = m_outFile.size();
+  if( l_len >= 4 && m_outFile.compare( l_len - 4, 4, ".ebm" ) == 0 )
+    writeBinFile();
+  else
+    writeDatFile();
+
+  //! Per-part dat files
+  writePartitions();
+
+  return true;
+}
+
+//! Index and coordinate types the writer is dispatched to
+template struct Eureka::NodeTable< uint32_t, float >;
+template struct Eureka::NodeTable< uint32_t, double >;
+template struct Eureka::NodeTable< uint64_t, float >;
+template struct Eureka::NodeTable< uint64_t, double >;
 
-  //! Write dat file
-  writeDatFile();
-}
\ No newline at end of file
+template class Eureka::Writer< uint32_t, float >;
+template class Eureka::Writer< uint32_t, double >;
+template class Eureka::Writer< uint64_t, float >;
+template class Eureka::Writer< uint64_t, double >;
\ No newline at end of file
@@ -31,27 +31,107 @@
 #ifndef EUREKA_WRITER_HPP
 #define EUREKA_WRITER_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <map>
+#include <algorithm>
 
+#include "EurekaBinary.h"
 #include "EurekaConstants.h"
+#include "EurekaGrid.hpp"
+#include "EurekaGroups.hpp"
+#include "EurekaMmap.hpp"
+#include "EurekaMsh.hpp"
+#include "EurekaOrder.hpp"
+#include "EurekaOut.hpp"
+#include "EurekaParse.hpp"
+#include "EurekaPart.hpp"
+#include "EurekaQual.hpp"
+#include "EurekaThreads.hpp"
 #include "../GeoGen/Geo.hpp"
+#include "../GeoGen/GeoManifest.h"
 
 namespace Eureka {
-  struct Node;
-  struct Elem;
+  template< typename R > struct Point;
+  template< typename I, typename R > struct NodeTable;
+  template< typename I > struct Elem;
+  template< typename I > struct DatChunk;
+  template< typename I > struct DatGroup;
   struct Material;
 
-  class Writer;
+  class WriterBase;
+  template< typename I, typename R > class Writer;
+
+  void selectTypes( const char *i_confFile,
+                    const UID  &i_maxIndex,
+                    bool       &o_wideIndex,
+                    bool       &o_autoIndex,
+                    bool       &o_singleCoords );
 }
 
+//! ----------------------------------------------------------------------------
+//! Stored node coordinates (single or double precision)
+//! ----------------------------------------------------------------------------
+template< typename R >
+struct Eureka::Point {
+  R m_x, m_y, m_z;
+
+  Point() : m_x(0), m_y(0), m_z(0) {}
+
+  Point( const geo::Vector &i_P ) : m_x(i_P.m_x), m_y(i_P.m_y), m_z(i_P.m_z) {}
+
+  operator geo::Vector() const { return geo::Vector( m_x, m_y, m_z ); }
+};
+
+//! ----------------------------------------------------------------------------
+//! Node coordinates stored in slots: the node ID itself when IDs are dense,
+//! else the position in the sorted ID table
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+struct Eureka::NodeTable {
+  //! Slot of a missing ID
+  static constexpr size_t NONE = (size_t) -1;
+
+  //! Sorted node IDs (empty if dense)
+  std::vector< I > m_ids;
+
+  //! Coordinates and (dense) presence of every slot
+  std::vector< Eureka::Point< R > > m_coords;
+  std::vector< bool >               m_used;
+
+  bool build( const std::vector< Eureka::MshBlock > &i_blocks );
+
+  size_t size() const { return m_coords.size(); }
+
+  //! Slot of node ID (NONE if missing)
+  size_t find( const UID &i_id ) const {
+    if( m_ids.empty() )
+      return (i_id < m_used.size() && m_used[i_id]) ? i_id : NONE;
+
+    typename std::vector< I >::const_iterator l_it = std::lower_bound( m_ids.begin(),
+                                                                       m_ids.end(), i_id );
+    return (l_it != m_ids.end() && *l_it == i_id) ? l_it - m_ids.begin() : NONE;
+  }
+
+  //! Node ID of (used) slot
+  UID id( const size_t &i_slot ) const {
+    return m_ids.empty() ? i_slot : m_ids[i_slot];
+  }
+
+  bool used( const size_t &i_slot ) const {
+    return m_ids.empty() ? m_used[i_slot] : true;
+  }
+};
+
 //! ----------------------------------------------------------------------------
 //! Tetrahedron element data-structure
 //! ----------------------------------------------------------------------------
+template< typename I >
 struct Eureka::Elem {
-  UID m_node1, m_node2, m_node3, m_node4;
+  I m_node1, m_node2, m_node3, m_node4;
 
   Elem() : m_node1(0), m_node2(0), m_node3(0), m_node4(0) {}
 
@@ -63,75 +143,262 @@ struct Eureka::Elem {
 };
 
 //! ----------------------------------------------------------------------------
-//! Node data-structure
+//! Chunk of the .dat file: header text, then lines [m_beg, m_end) of a section
+//! (node slots, elements or IDs of a group)
+//! ----------------------------------------------------------------------------
+template< typename I >
+struct Eureka::DatChunk {
+  enum Kind : unsigned char {
+    NODES,
+    ELEMS,
+    GROUP
+  };
+
+  std::string m_header;
+  Kind m_kind;
+  const std::vector< I > *m_list;
+  size_t m_beg, m_end;
+
+  DatChunk( const std::string      &i_header,
+            const Kind             &i_kind,
+            const std::vector< I > *i_list,
+            const size_t           &i_beg,
+            const size_t           &i_end ) : m_header(i_header), m_kind(i_kind),
+                                              m_list(i_list), m_beg(i_beg),
+                                              m_end(i_end) {}
+};
+
+//! ----------------------------------------------------------------------------
+//! Nodal (code 7) or element (code 8) group of the output
+//! ----------------------------------------------------------------------------
+template< typename I >
+struct Eureka::DatGroup {
+  int m_code;
+  std::string m_name;
+  const std::vector< I > *m_list;
+};
+
+//! ----------------------------------------------------------------------------
+//! Material data-structure
 //! ----------------------------------------------------------------------------
 struct Eureka::Material {
   std::string m_name;
   geo::Morph m_morph;
   UID m_numParticles;
-  std::vector< real > m_radList;
-  std::vector< std::pair< geo::Vector, geo::Vector > > m_cylCP;
-  std::vector< geo::Vector > m_sphCP;
-  std::vector< UID > m_elemList;
 
-  Material() {}
+  //! Radius and control points (end points for cylinder, center for sphere)
+  //! of each particle, pointing straight into the mapped manifest
+  const real *m_radList;
+  const real *m_cpList;
+  unsigned int m_cpStride;
+
+  Material() : m_numParticles(0), m_radList(nullptr), m_cpList(nullptr),
+               m_cpStride(0) {}
+
+  Material( const std::string &i_name ) : m_name(i_name), m_numParticles(0),
+                                          m_radList(nullptr), m_cpList(nullptr),
+                                          m_cpStride(0) {}
 
-  Material( const std::string &i_name ) : m_name(i_name) {}
+  //! i_k-th control point of i_i-th particle
+  geo::Vector getCP( const UID &i_i,
+                     const unsigned int &i_k = 0 ) const {
+    const real *l_cp = m_cpList + i_i * m_cpStride + 3 * i_k;
+    return geo::Vector( l_cp[0], l_cp[1], l_cp[2] );
+  }
 };
 
 //! ----------------------------------------------------------------------------
-//! Writer class
+//! Writer state independent of index and coordinate types: settings,
+//! materials and the .msh parser
 //! ----------------------------------------------------------------------------
-class Eureka::Writer {
-private:
+class Eureka::WriterBase {
+protected:
   clock_t m_time;
 
-  UID m_elemID, m_badElems, m_numOfNodes;
+  UID m_elemID, m_numOfNodes;
   real m_length, m_width, m_height, m_pistonThicc;
 
-  //! Node and element list
-  std::map< UID, geo::Vector >  m_nodeMap;
-  std::map< UID, Eureka::Elem > m_elemMap;
-
-  //! Material list
+  //! Material list and grid over its particles (built once a tet without a
+  //! known physical volume shows up), with voxel labels (voxels along the
+  //! longest axis, 0: none, LABELAUTO: sized by the number of elements from
+  //! the $Elements header)
   std::vector< Eureka::Material * > m_matList;
+  Eureka::ParticleGrid              m_grid;
+  bool                              m_gridBuilt;
+  long                              m_labelRes;
+  UID                               m_numElems;
+
+  //! Quality metric
+  Eureka::TetQuality m_qual;
+
+  //! Number of histogram bins (0: none) and whether to write bad_elems group
+  int  m_qualBins;
+  bool m_badGroup;
+
+  //! Physical (volume) tag to element group (0: matrix, 1: piston, 2 + m:
+  //! material m)
+  std::map< UID, size_t > m_physMap;
+
+  //! Physical (surface) tag to box face map
+  std::map< UID, Eureka::Face > m_faceMap;
+
+  //! Nodal group definitions and tolerance of the predicates found from node
+  //! coordinates (box faces of untagged meshes, piston)
+  Eureka::NodeGroups m_nodeGroupDefs;
+  real               m_nodeTol;
+
+  //! Node and element renumbering before writing
+  Eureka::Ordering m_nodeOrder, m_elemOrder;
+
+  //! Number of parts (below 2: none) and whether to refine them
+  unsigned int m_numParts;
+  bool         m_partRefine;
+
+  //! Streaming (bounded memory) mode and where it spills to (default: next
+  //! to the output file)
+  bool        m_stream;
+  std::string m_spillDir;
+
+  //! .msh file mapping (owned by the caller), read position and layout
+  const Eureka::MappedFile &m_msh;
+  const char *m_mshPos;
+  Eureka::MshFormat m_mshFormat;
+
+  //! (4.1) Entity (dimension, tag) to physical tag map
+  std::map< std::pair< int, int >, UID > m_entityPhys;
+
+  //! .dat file
+  std::string     m_outFile;
+  Eureka::OutFile m_out;
+
+  //! Worker threads
+  Eureka::ThreadPool m_pool;
+
+  //! Material manifest
+  std::string m_matFile;
+  Eureka::MappedFile m_mat;
 
-  //! Matrix and piston list
-  std::vector< UID > m_matrixList, m_pistonList;
-
-  //! Nodal groups
-  std::vector< UID > m_topNodes,    m_bottomNodes;
-  std::vector< UID > m_leftNodes,   m_rightNodes;
-  std::vector< UID > m_frontNodes,  m_backNodes;
-  std::vector< UID > m_cornerNodes, m_topCornerNodes;
-  std::vector< UID > m_zLeftNodes,  m_zRightNodes;
-  std::vector< UID > m_yLeftNodes,  m_yRightNodes;
-  std::vector< UID > m_xFrontNodes, m_xBackNodes;
-  std::vector< UID > m_matrixNodes, m_pistonNodes;
-
-  std::ifstream m_inMsh, m_inMat;
-  std::ofstream m_out;
-
-  void checkElemQual( const geo::Vector &i_A,
-                      const geo::Vector &i_B,
-                      const geo::Vector &i_C,
-                      const geo::Vector &i_D );
   void parseMaterials();
-  void readNodes();
+  void buildGrid( const std::vector< Eureka::MshBlock > &i_blocks,
+                  const size_t                          &i_first,
+                  const size_t                          &i_num );
+  void printGrid() const;
+  void mshError( const char *i_what,
+                 const char *i_pos ) const;
+  bool nextLine( const char *&o_beg,
+                 const char *&o_end );
+  void findSection( const char *i_name );
+  void readMeshFormat();
+  void readPhysicalNames();
+  void readEntities();
+  UID  entityPhys( const int &i_dim,
+                   const int &i_tag ) const;
+  void splitSection( const char                      *i_endTag,
+                     std::vector< Eureka::MshBlock > &o_blocks );
+  void splitRecords( const UID                       &i_num,
+                     const Eureka::MshBlock          &i_block,
+                     std::vector< Eureka::MshBlock > &o_blocks );
+  void checkBlocks( const char                            *i_what,
+                    const std::vector< Eureka::MshBlock > &i_blocks ) const;
+  void splitNodes( std::vector< Eureka::MshBlock > &o_blocks );
+  void splitElems( std::vector< Eureka::MshBlock > &o_blocks );
+  void parseNodes( Eureka::MshBlock &io_block ) const;
+  void addElem( Eureka::MshBlock &io_block,
+                const long       &i_type,
+                const UID        &i_phys,
+                const UID        (&i_nodes)[4] ) const;
+  void parseElems( Eureka::MshBlock &io_block ) const;
+  void classifyNodes( Eureka::MshBlock &io_block ) const;
+
+public:
+  WriterBase( const Eureka::MappedFile &i_msh,
+              const UID                &i_numElems,
+              const char               *i_outFile,
+              const char               *i_matFile );
+  ~WriterBase();
+
+  void parseConfigFile( const char *i_filename );
+};
+
+//! ----------------------------------------------------------------------------
+//! Writer class, storing node IDs and connectivity as I and coordinates as R
+//! ----------------------------------------------------------------------------
+template< typename I, typename R >
+class Eureka::Writer : public Eureka::WriterBase {
+private:
+  //! Node table and element connectivity (element ID i at i - 1)
+  Eureka::NodeTable< I, R >        m_nodes;
+  std::vector< Eureka::Elem< I > > m_elems;
+
+  //! Matrix, piston and material (by material) element lists
+  std::vector< I > m_matrixList, m_pistonList;
+  std::vector< std::vector< I > > m_matElems;
+
+  //! Quality of every element (ID i at i - 1) and bad elements
+  std::vector< float > m_elemQual;
+  std::vector< I >     m_badList;
+
+  //! Predicates of every node (by slot)
+  std::vector< uint16_t > m_nodePreds;
+
+  //! Nodal groups, in the order of their definitions
+  std::vector< std::vector< I > > m_nodeGroups;
+
+  size_t nodeSlot( const UID &i_id ) const;
+  bool elemSlots( const Eureka::Elem< I > &i_elem,
+                  size_t                  (&o_slots)[4],
+                  UID                     &o_missing ) const;
+  void checkMissing( const std::vector< UID > &i_missing ) const;
+  bool readNodes();
+  void elemGroups( std::vector< std::vector< I > * > &o_groups );
+  void classifyElems( const Eureka::MshBlock             &i_block,
+                      const UID                          &i_firstID,
+                      Eureka::Elem< I >                  *o_elems,
+                      float                              *o_qual,
+                      std::vector< std::vector< I > >    &o_lists,
+                      std::vector< I >                   &o_bad,
+                      std::vector< std::atomic< bool > > &io_inMatrix,
+                      const UID                         *&o_missing ) const;
+  void markMatrixNodes( const std::vector< std::atomic< bool > > &i_inMatrix );
   void readElems();
+  void nodeGroupsOf( std::vector< std::vector< unsigned int > > &o_groupsOf ) const;
+  void buildNodalGroups();
+  void elemCentroids( std::vector< geo::Vector > &o_centroids );
+  void renumberNodes();
+  void renumberElems();
+  void printQuality() const;
+  void listGroups( std::vector< Eureka::DatGroup< I > > &o_groups ) const;
+  void addChunks( const std::string                         &i_header,
+                  const typename Eureka::DatChunk< I >::Kind &i_kind,
+                  const std::vector< I >                    *i_list,
+                  const size_t                              &i_num,
+                  std::vector< Eureka::DatChunk< I > >      &io_chunks ) const;
+  void formatChunk( const Eureka::DatChunk< I > &i_chunk,
+                    Eureka::OutBuffer           &o_buf ) const;
+  size_t writeChunks( const std::vector< Eureka::DatChunk< I > > &i_chunks,
+                      const size_t                               &i_offset = 0 );
   void writeDatFile();
-  void writeNodes();
-  void writeElems();
-  void writeNodalGroups();
-  void writeElementGroups();
+  void writeBinFile();
+  void writePartitions();
+  bool streamMshWriteDat();
 
 public:
-  Writer( const char *i_inFile,
-          const char *i_outFile );
-  ~Writer();
+  Writer( const Eureka::MappedFile &i_msh,
+          const UID                &i_numElems,
+          const char               *i_outFile,
+          const char               *i_matFile ) : Eureka::WriterBase( i_msh, i_numElems,
+                                                                      i_outFile, i_matFile ) {}
 
-  void parseConfigFile( const char *i_filename );
-  void readMshWriteDat();
+  bool readMshWriteDat();
 };
 
+//! Instantiated (in EurekaWriter.cpp) for 32/64-bit indices and single/double
+//! precision coordinates
+namespace Eureka {
+  extern template class Writer< uint32_t, float >;
+  extern template class Writer< uint32_t, double >;
+  extern template class Writer< uint64_t, float >;
+  extern template class Writer< uint64_t, double >;
+}
+
 #endif
\ No newline at end of file
@@ -66,6 +66,15 @@ namespace geo {
   extern Vector unitcross( const Vector &i_vec1,
                            const Vector &i_vec2 );
 
+  extern real distPointSegment( const Vector &i_P,
+                                const Vector &i_A,
+                                const Vector &i_B );
+
+  extern real distSegments( const Vector &i_A1,
+                            const Vector &i_B1,
+                            const Vector &i_A2,
+                            const Vector &i_B2 );
+
   extern Matrix getRotMat( const Vector &i_a1,
                            const Vector &i_a2 );
 
@@ -0,0 +1,285 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Config file parser of GeoGen.
+ **/
+
+#include <fstream>
+#include <stdexcept>
+
+#include "GeoConfig.h"
+
+//! ----------------------------------------------------------------------------
+//! Name of a status code
+//! ----------------------------------------------------------------------------
+const char *geo::statusString( const geo::Status &i_status ) {
+  switch( i_status ) {
+    case geo::Status::SUCCESS:       return "success";
+    case geo::Status::ERR_IO:        return "I/O error";
+    case geo::Status::ERR_CONFIG:    return "invalid configuration";
+    case geo::Status::ERR_IMPORT:    return "invalid particle import";
+    case geo::Status::ERR_INSERTION: return "particle insertion failed";
+    case geo::Status::ERR_MANIFEST:  return "material manifest error";
+  }
+
+  return "unknown status";
+}
+
+//! ----------------------------------------------------------------------------
+//! Checks if value in config entry is empty
+//! ----------------------------------------------------------------------------
+static bool chkEmpty( const std::string &i_name,
+                      const std::string &i_val,
+                      std::string       &o_error,
+                      const std::string &i_mat = "" ) {
+  if( i_val.empty() ) {
+    o_error = "No value found for " + i_name +
+              (!i_mat.empty() ? " in " + i_mat : "");
+    return false;
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Config parser (from any input stream)
+//! ----------------------------------------------------------------------------
+geo::Status geo::parseConfig( std::istream &i_in,
+                              geo::Config  &o_config,
+                              std::string  &o_error,
+                              std::ostream *o_log ) {
+  std::string l_lineBuf;
+  geo::Material *l_mat = nullptr;
+
+  while( getline( i_in, l_lineBuf ) ) {
+    size_t l_k = -1, l_l;
+
+    while( (++l_k < l_lineBuf.length()) && (l_lineBuf[l_k] == ' ') );
+
+    if( (l_k >= l_lineBuf.length()) || (l_lineBuf[l_k] == '#') )
+      continue;
+
+    l_l = l_k - 1;
+
+    while( (++l_l < l_lineBuf.length()) && (l_lineBuf[l_l] != '=') );
+
+    if( l_l >= l_lineBuf.length() )
+      continue;
+
+    std::string l_varName  = l_lineBuf.substr( l_k, l_l - l_k );
+    std::string l_varValue = l_lineBuf.substr( l_l + 1 );
+
+    //! Skip specific entries without values
+    if( l_varValue.empty() &&
+         (l_varName == "length" || l_varName == "width" || l_varName == "height"
+       || l_varName == "tol_particles_boundaries" || l_varName == "count"
+       || l_varName == "tol_particles" || l_varName == "piston_thicc"
+       || l_varName == "global_mesh_size" || l_varName == "mesh_size"
+       || l_varName == "rand_seed" || l_varName == "vol_frac" ) )
+      continue;
+
+    //! Material settings need an enclosing material block
+    if( !l_mat &&
+         (l_varName == "vol_frac" || l_varName == "count"
+       || l_varName == "mesh_size" || l_varName == "morph"
+       || l_varName.compare( 0, 4, "rad_" ) == 0
+       || l_varName.compare( 0, 4, "len_" ) == 0) ) {
+      o_error = "Setting " + l_varName + " outside of a material block";
+      return geo::Status::ERR_CONFIG;
+    }
+
+    //! Numeric conversions throw on malformed values
+    try {
+      //! Box
+      if( l_varName == "length" )
+        o_config.m_length       = StrToReal( l_varValue );
+      else if( l_varName == "width" )
+        o_config.m_width        = StrToReal( l_varValue );
+      else if( l_varName == "height" )
+        o_config.m_height       = StrToReal( l_varValue );
+      else if( l_varName == "global_mesh_size" )
+        o_config.m_meshSize     = StrToReal( l_varValue );
+
+      //! Tolerance values
+      else if( l_varName == "tol_particles" )
+        o_config.m_tolParticles = StrToReal( l_varValue );
+      else if( l_varName == "tol_particles_boundaries" )
+        o_config.m_tolPartBound = StrToReal( l_varValue );
+
+      //! Random seed
+      else if( l_varName == "rand_seed" )
+        o_config.m_seed         = StrToID( l_varValue );
+
+      //! Piston thickness
+      else if( l_varName == "piston_thicc" )
+        o_config.m_pistonThicc  = StrToID( l_varValue );
+
+      //! Material
+      else if( l_varName == "material" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error ) )
+          return geo::Status::ERR_CONFIG;
+        o_config.m_matList.push_back( geo::Material() );
+        l_mat = &o_config.m_matList.back();
+        l_mat->m_name     = l_varValue;
+      }
+      else if( l_varName == "vol_frac" )
+        l_mat->m_volFrac  = StrToReal( l_varValue );
+      else if( l_varName == "count" )
+        l_mat->m_count    = StrToID( l_varValue );
+      else if( l_varName == "mesh_size" )
+        l_mat->m_meshSize = StrToReal( l_varValue );
+      else if( l_varName == "morph" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        if( (l_varValue == "cylinder") || (l_varValue == "cyl") )
+          l_mat->m_morph  = geo::Morph::CYLINDER;
+        else if( (l_varValue == "sphere") || (l_varValue == "sph") )
+          l_mat->m_morph  = geo::Morph::SPHERE;
+        else {
+          o_error = "Unknown morphology (" + l_varValue + ")";
+          return geo::Status::ERR_CONFIG;
+        }
+      }
+
+      else if( l_varName == "rad_distrib" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        if( l_varValue == "gaussian" || l_varValue == "gauss" )
+          l_mat->m_radDistrib = geo::Distrib::GAUSSIAN;
+        else if( l_varValue == "uniform" || l_varValue == "flat" )
+          l_mat->m_radDistrib = geo::Distrib::UNIFORM;
+        else {
+          o_error = "Unknown distribution (" + l_varValue + ")";
+          return geo::Status::ERR_CONFIG;
+        }
+      }
+      else if( l_varName == "rad_mean" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        if( l_mat->m_radDistrib == geo::Distrib::GAUSSIAN )
+          l_mat->m_radMean  = StrToReal( l_varValue );
+        else {
+          o_error = "Cannot use rad_mean with Uniform distribution (specify "
+                    "rad_min & rad_max OR use Gaussian distribution)";
+          return geo::Status::ERR_CONFIG;
+        }
+      }
+      else if( l_varName == "rad_min" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_radMin     = StrToReal( l_varValue );
+      }
+      else if( l_varName == "rad_max" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_radMax     = StrToReal( l_varValue );
+      }
+      else if( l_varName == "rad_std_dev" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_radStdDev  = StrToReal( l_varValue );
+      }
+
+      else if( l_varName == "len_distrib" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        if( l_mat->m_morph == geo::Morph::SPHERE ) {
+          o_error = "Cannot use len specs with sphere morphology";
+          return geo::Status::ERR_CONFIG;
+        }
+
+        if( l_varValue == "gaussian" || l_varValue == "gauss" )
+          l_mat->m_lenDistrib  = geo::Distrib::GAUSSIAN;
+        else if( l_varValue == "uniform" || l_varValue == "flat" )
+          l_mat->m_lenDistrib  = geo::Distrib::UNIFORM;
+        else {
+          o_error = "Unknown distribution (" + l_varValue + ")";
+          return geo::Status::ERR_CONFIG;
+        }
+      }
+      else if( l_varName == "len_mean" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        if( l_mat->m_morph == geo::Morph::SPHERE ) {
+          o_error = "Cannot use len specs with sphere morphology";
+          return geo::Status::ERR_CONFIG;
+        }
+
+        if( l_mat->m_lenDistrib == geo::Distrib::GAUSSIAN )
+          l_mat->m_lenMean = StrToReal( l_varValue );
+        else {
+          o_error = "Cannot use len_mean with Uniform distribution (specify "
+                    "len_min & len_max OR use Gaussian distribution)";
+          return geo::Status::ERR_CONFIG;
+        }
+      }
+      else if( l_varName == "len_min" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_lenMin     = StrToReal( l_varValue );
+      }
+      else if( l_varName == "len_max" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_lenMax     = StrToReal( l_varValue );
+      }
+      else if( l_varName == "len_std_dev" ) {
+        if( !chkEmpty( l_varName, l_varValue, o_error, l_mat->m_name ) )
+          return geo::Status::ERR_CONFIG;
+        l_mat->m_lenStdDev  = StrToReal( l_varValue );
+      }
+
+      else if( o_log )
+        *o_log << "Unknown setting (" << l_varName << "). Ignored.\n";
+    } catch( const std::exception & ) {
+      o_error = "Invalid value for " + l_varName + " (" + l_varValue + ")";
+      return geo::Status::ERR_CONFIG;
+    }
+  }
+
+  return geo::Status::SUCCESS;
+}
+
+//! ----------------------------------------------------------------------------
+//! Config file parser
+//! ----------------------------------------------------------------------------
+geo::Status geo::parseConfigFile( const char   *i_filename,
+                                  geo::Config  &o_config,
+                                  std::string  &o_error,
+                                  std::ostream *o_log ) {
+  std::ifstream l_confFn( i_filename, std::ios::in );
+  if( !l_confFn.is_open() ) {
+    o_error = std::string( "Cannot open " ) + i_filename;
+    return geo::Status::ERR_IO;
+  }
+
+  geo::Status l_status = parseConfig( l_confFn, o_config, o_error, o_log );
+
+  l_confFn.close();
+
+  return l_status;
+}
\ No newline at end of file
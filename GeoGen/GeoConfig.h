@@ -0,0 +1,127 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Configuration, status codes and config file parser of GeoGen.
+ **/
+
+#ifndef GEO_CONFIG_H
+#define GEO_CONFIG_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "Geo.hpp"
+
+namespace geo {
+  enum class Distrib {
+    GAUSSIAN,
+    UNIFORM
+  };
+
+  //! Result of library calls (details in the accompanying error message)
+  enum class Status {
+    SUCCESS,
+    ERR_IO,           //! Cannot open, read or write a file/stream
+    ERR_CONFIG,       //! Invalid or incomplete configuration
+    ERR_IMPORT,       //! Malformed or invalid imported particles
+    ERR_INSERTION,    //! Random insertion reached its iteration limit
+    ERR_MANIFEST      //! Material manifest cannot be written
+  };
+
+  struct Material;
+  struct Config;
+
+  extern const char *statusString( const Status &i_status );
+
+  extern Status parseConfig( std::istream &i_in,
+                             Config       &o_config,
+                             std::string  &o_error,
+                             std::ostream *o_log = nullptr );
+
+  extern Status parseConfigFile( const char   *i_filename,
+                                 Config       &o_config,
+                                 std::string  &o_error,
+                                 std::ostream *o_log = nullptr );
+}
+
+//! ----------------------------------------------------------------------------
+//! Material-block data-structure
+//! ----------------------------------------------------------------------------
+struct geo::Material {
+  real        m_meshSize, m_radMean, m_lenMean, m_radStdDev, m_lenStdDev;
+  real        m_volFrac, m_radMin, m_radMax, m_lenMin, m_lenMax;
+  ID          m_count;
+  std::string m_name;
+  Morph       m_morph;
+  Distrib     m_radDistrib, m_lenDistrib;
+
+  //! Volume IDs of the material particles
+  std::vector< ID > m_volList;
+
+  //! Radius and control points of the material particles (for manifest)
+  std::vector< real > m_radList, m_cpList;
+
+  Material() : m_meshSize(0.0), m_radMean(0.0), m_lenMean(0.0),
+               m_radStdDev(0.0), m_lenStdDev(0.0), m_volFrac(0.0),
+               m_radMin(0.0), m_radMax(0.0), m_lenMin(0.0), m_lenMax(0.0),
+               m_count(0), m_morph(Morph::CYLINDER),
+               m_radDistrib(Distrib::GAUSSIAN),
+               m_lenDistrib(Distrib::GAUSSIAN) {}
+};
+
+//! ----------------------------------------------------------------------------
+//! Parsed config file (box, tolerances, seed and material blocks)
+//! ----------------------------------------------------------------------------
+struct geo::Config {
+  //! Box dimensions
+  real m_length, m_width, m_height;
+
+  //! Global mesh size
+  real m_meshSize;
+
+  //! Tolerance between particles
+  real m_tolParticles;
+
+  //! Tolerance between paritcles and boundaries
+  real m_tolPartBound;
+
+  //! Piston thickness
+  real m_pistonThicc;
+
+  //! Random seed (0: seeded from system time)
+  unsigned int m_seed;
+
+  //! Material blocks
+  std::vector< geo::Material > m_matList;
+
+  Config() : m_length(10000.0), m_width(5000.0), m_height(5500.0),
+             m_meshSize(200.0), m_tolParticles(50.0), m_tolPartBound(50.0),
+             m_pistonThicc(500.0), m_seed(0) {}
+};
+
+#endif
\ No newline at end of file
@@ -28,34 +28,97 @@
  * GeoGen program.
  **/
 
+#include <ctime>
+#include <fstream>
+
 #include "GeoWriter.h"
 
 //! ----------------------------------------------------------------------------
-//! Main program: GeoGen
+//! Main program: GeoGen (command-line front-end of libgeogen)
 //! ----------------------------------------------------------------------------
 int main( int i_argc, char **i_argv ) {
-  if( i_argc != 5 ) {
-    std::cerr << "Usage: " << i_argv[0] << " -f conf_file -o geo_file\n";
+  //! Start time
+  clock_t l_time = clock();
+
+  //! Filenames (material manifest defaults to GeoGen.mat)
+  std::string l_configFile, l_geoFile, l_matFile = "GeoGen.mat", l_partFile;
+
+  //! Options come in pairs: -flag value
+  for( int l_i = 1; l_i < i_argc; l_i += 2 ) {
+    if( (l_i + 1 >= i_argc) || (i_argv[l_i][0] != '-') ) {
+      l_configFile.clear();
+      break;
+    }
+
+    switch( i_argv[l_i][1] ) {
+      case 'f':
+        l_configFile = std::string( i_argv[l_i + 1] );
+        break;
+      case 'o':
+        l_geoFile    = std::string( i_argv[l_i + 1] );
+        break;
+      case 'm':
+        l_matFile    = std::string( i_argv[l_i + 1] );
+        break;
+      case 'p':
+        l_partFile   = std::string( i_argv[l_i + 1] );
+        break;
+      default:
+        l_configFile.clear();
+        break;
+    }
+  }
+
+  if( l_configFile.empty() || l_geoFile.empty() ) {
+    std::cerr << "Usage: " << i_argv[0]
+              << " -f conf_file -o geo_file [-m mat_file] [-p particle_file]\n";
     return EXIT_FAILURE;
-  } else if( (i_argv == nullptr)   ||
-             (i_argv[1][0] != '-') || (i_argv[1][1] != 'f') ||
-             (i_argv[3][0] != '-') || (i_argv[3][1] != 'o') ) {
-    std::cerr << "Usage: " << i_argv[0] << " -f conf_file -o geo_file\n";
+  }
+
+  //! Parse config file
+  geo::Config l_config;
+  std::string l_error;
+  if( geo::parseConfigFile( l_configFile.c_str(), l_config, l_error,
+                            &std::cerr ) != geo::Status::SUCCESS ) {
+    std::cerr << l_error << "! Exiting..\n";
     return EXIT_FAILURE;
   }
 
-  //! Filenames
-  std::string l_configFile = std::string( i_argv[2] );
-  std::string l_geoFile    = std::string( i_argv[4] );
+  //! Output files
+  std::ofstream l_geo( l_geoFile.c_str(), std::ofstream::out );
+  if( !l_geo.is_open() ) {
+    std::cerr << "Couldn't open " << l_geoFile << "! Exiting..\n";
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream l_mat( l_matFile.c_str(), std::ofstream::out | std::ofstream::binary );
+  if( !l_mat.is_open() ) {
+    std::cerr << "Couldn't open " << l_matFile << "! Exiting..\n";
+    return EXIT_FAILURE;
+  }
 
   //! Writer object
-  geo::Writer l_writer( l_geoFile.c_str() );
+  geo::Writer l_writer( l_config, l_geo, l_mat, &std::cout );
 
-  //! Parse config file
-  l_writer.parseConfigFile( l_configFile.c_str() );
+  //! Import particles instead of inserting them at random
+  if( !l_partFile.empty() &&
+      l_writer.importParticles( l_partFile.c_str() ) != geo::Status::SUCCESS ) {
+    std::cerr << l_writer.getError() << "! Exiting..\n";
+    return EXIT_FAILURE;
+  }
 
   //! Write geo file
-  l_writer.writeGeo();
+  if( l_writer.writeGeo() != geo::Status::SUCCESS ) {
+    std::cerr << l_writer.getError() << "! Exiting..\n";
+    return EXIT_FAILURE;
+  }
+
+  l_geo.close();
+  l_mat.close();
+
+  //! Display time taken
+  l_time = clock() - l_time;
+  std::cout << "Done!\nTime taken = " << (float) l_time / CLOCKS_PER_SEC << "s\n";
 
   return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,692 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Bulk particle import for GeoGen.
+ **/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include "GeoWriter.h"
+
+//! ----------------------------------------------------------------------------
+//! Number of worker threads
+//! ----------------------------------------------------------------------------
+static unsigned int numThreads() {
+  unsigned int l_n = std::thread::hardware_concurrency();
+  return (l_n ? l_n : 1);
+}
+
+//! ----------------------------------------------------------------------------
+//! Run i_fn( t ) for t in [0, i_num) on one thread each and wait for all
+//! ----------------------------------------------------------------------------
+template< typename F >
+static void runThreads( unsigned int i_num, F i_fn ) {
+  std::vector< std::thread > l_threads;
+  for( unsigned int l_t = 0; l_t < i_num; l_t++ )
+    l_threads.push_back( std::thread( i_fn, l_t ) );
+  for( unsigned int l_t = 0; l_t < i_num; l_t++ )
+    l_threads[l_t].join();
+}
+
+//! ----------------------------------------------------------------------------
+//! Morphology from its name (returns false if unknown)
+//! ----------------------------------------------------------------------------
+static bool parseMorph( const std::string &i_val,
+                        geo::Morph        &o_morph ) {
+  if( (i_val == "cylinder") || (i_val == "cyl") )
+    o_morph = geo::Morph::CYLINDER;
+  else if( (i_val == "sphere") || (i_val == "sph") )
+    o_morph = geo::Morph::SPHERE;
+  else
+    return false;
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Axis-aligned bounding box of a particle
+//! ----------------------------------------------------------------------------
+static void getBounds( const geo::Particle &i_part,
+                       geo::Vector         &o_min,
+                       geo::Vector         &o_max ) {
+  real l_ext[3] = { i_part.m_rad, i_part.m_rad, i_part.m_rad };
+
+  //! Cylinder faces extend by r * sqrt(1 - d_i^2) along each axis
+  if( i_part.m_morph == geo::Morph::CYLINDER ) {
+    geo::Vector l_d( i_part.m_A, i_part.m_B );
+    real l_len = geo::norm( l_d );
+    real l_dir[3] = { l_d.m_x / l_len, l_d.m_y / l_len, l_d.m_z / l_len };
+
+    for( int l_i = 0; l_i < 3; l_i++ )
+      l_ext[l_i] = i_part.m_rad * sqrt( std::max( 0.0, 1.0 - l_dir[l_i] * l_dir[l_i] ) );
+  }
+
+  o_min = geo::Vector( std::min( i_part.m_A.m_x, i_part.m_B.m_x ) - l_ext[0],
+                       std::min( i_part.m_A.m_y, i_part.m_B.m_y ) - l_ext[1],
+                       std::min( i_part.m_A.m_z, i_part.m_B.m_z ) - l_ext[2] );
+  o_max = geo::Vector( std::max( i_part.m_A.m_x, i_part.m_B.m_x ) + l_ext[0],
+                       std::max( i_part.m_A.m_y, i_part.m_B.m_y ) + l_ext[1],
+                       std::max( i_part.m_A.m_z, i_part.m_B.m_z ) + l_ext[2] );
+}
+
+//! ----------------------------------------------------------------------------
+//! Check if two particles (axis segments with radii) are closer than tolerance
+//! ----------------------------------------------------------------------------
+static bool particlesCollide( const geo::Particle &i_p1,
+                              const geo::Particle &i_p2,
+                              const real          &i_tol ) {
+  real l_d = geo::distSegments( i_p1.m_A, i_p1.m_B, i_p2.m_A, i_p2.m_B );
+
+  return (l_d <= (i_p1.m_rad + i_p2.m_rad + i_tol));
+}
+
+//! ----------------------------------------------------------------------------
+//! Find material by name or create it (returns index into material list, or
+//! -1 on conflicting morphology)
+//! ----------------------------------------------------------------------------
+ID geo::Writer::getMaterial( const std::string &i_name,
+                             const geo::Morph  &i_morph ) {
+  for( size_t l_i = 0; l_i < m_matList.size(); l_i++ ) {
+    if( m_matList[l_i].m_name != i_name )
+      continue;
+
+    if( m_matList[l_i].m_morph != i_morph ) {
+      setError( geo::Status::ERR_IMPORT, "Conflicting morphology for " + i_name );
+      return -1;
+    }
+
+    return l_i;
+  }
+
+  //! Material without a config block uses the global mesh size
+  geo::Material l_mat;
+  l_mat.m_name  = i_name;
+  l_mat.m_morph = i_morph;
+  m_matList.push_back( l_mat );
+
+  return m_matList.size() - 1;
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse CSV particle file (chunks of lines in parallel)
+//! ----------------------------------------------------------------------------
+bool geo::Writer::parseCsvParticles( const std::string &i_buf ) {
+  //! Per-chunk parse results
+  struct Chunk {
+    size_t m_begin, m_end;
+    ID     m_numLines, m_errLine;
+
+    //! Parsed particles with material name (offset, length) into buffer
+    std::vector< geo::Particle > m_parts;
+    std::vector< std::pair< size_t, size_t > > m_names;
+
+    Chunk() : m_begin(0), m_end(0), m_numLines(0), m_errLine(0) {}
+  };
+
+  unsigned int l_numChunks = numThreads();
+  std::vector< Chunk > l_chunks( l_numChunks );
+
+  //! Split buffer into newline-aligned chunks
+  size_t l_pos = 0;
+  for( unsigned int l_c = 0; l_c < l_numChunks; l_c++ ) {
+    size_t l_end = (l_c + 1 == l_numChunks) ? i_buf.size() :
+                   std::max( l_pos, (l_c + 1) * i_buf.size() / l_numChunks );
+
+    l_end = i_buf.find( '\n', l_end );
+    l_end = (l_end == std::string::npos) ? i_buf.size() : l_end + 1;
+
+    l_chunks[l_c].m_begin = l_pos;
+    l_chunks[l_c].m_end   = l_end;
+    l_pos = l_end;
+  }
+
+  const char *l_data = i_buf.data();
+
+  auto l_parse = [&]( Chunk &io_chunk ) {
+    size_t l_line = io_chunk.m_begin;
+
+    while( l_line < io_chunk.m_end ) {
+      size_t l_eol = i_buf.find( '\n', l_line );
+      if( l_eol == std::string::npos || l_eol > io_chunk.m_end )
+        l_eol = io_chunk.m_end;
+
+      io_chunk.m_numLines++;
+
+      //! Split line at commas
+      size_t l_fields[10][2];
+      int    l_numFields = 0;
+      size_t l_f = l_line;
+
+      while( l_f <= l_eol && l_numFields < 10 ) {
+        size_t l_comma = l_f;
+        while( l_comma < l_eol && l_data[l_comma] != ',' )
+          l_comma++;
+
+        //! Trim blanks (and carriage return)
+        size_t l_b = l_f, l_e = l_comma;
+        while( l_b < l_e && (l_data[l_b] == ' ' || l_data[l_b] == '\t') )
+          l_b++;
+        while( l_e > l_b && (l_data[l_e - 1] == ' ' || l_data[l_e - 1] == '\t' ||
+                             l_data[l_e - 1] == '\r') )
+          l_e--;
+
+        l_fields[l_numFields][0] = l_b;
+        l_fields[l_numFields][1] = l_e - l_b;
+        l_numFields++;
+        l_f = l_comma + 1;
+      }
+
+      size_t l_next = l_eol + 1;
+
+      //! Skip blank lines, comments and header
+      if( (l_numFields == 1 && l_fields[0][1] == 0) ||
+          (l_fields[0][1] > 0 && l_data[l_fields[0][0]] == '#') ||
+          (i_buf.compare( l_fields[0][0], l_fields[0][1], "material" ) == 0) ) {
+        l_line = l_next;
+        continue;
+      }
+
+      geo::Particle l_part;
+      bool l_ok = (l_numFields >= 6) &&
+                  parseMorph( i_buf.substr( l_fields[1][0], l_fields[1][1] ),
+                              l_part.m_morph );
+
+      int l_numVals = (l_part.m_morph == geo::Morph::CYLINDER) ? 7 : 4;
+      real l_vals[7];
+
+      if( l_ok && l_numFields != 2 + l_numVals )
+        l_ok = false;
+
+      for( int l_i = 0; l_ok && l_i < l_numVals; l_i++ ) {
+        const char *l_beg = l_data + l_fields[2 + l_i][0];
+        char *l_stop;
+        l_vals[l_i] = strtod( l_beg, &l_stop );
+
+        if( l_stop != l_beg + l_fields[2 + l_i][1] || l_fields[2 + l_i][1] == 0 )
+          l_ok = false;
+      }
+
+      //! Cylinder axis must not be degenerate
+      if( l_ok && l_numVals == 7 && l_vals[1] == l_vals[4] &&
+          l_vals[2] == l_vals[5] && l_vals[3] == l_vals[6] )
+        l_ok = false;
+
+      if( !l_ok || l_fields[0][1] == 0 || l_vals[0] <= 0.0 ) {
+        io_chunk.m_errLine = io_chunk.m_numLines;
+        return;
+      }
+
+      l_part.m_rad = l_vals[0];
+      l_part.m_A   = geo::Vector( l_vals[1], l_vals[2], l_vals[3] );
+      l_part.m_B   = (l_numVals == 7) ? geo::Vector( l_vals[4], l_vals[5], l_vals[6] )
+                                      : l_part.m_A;
+
+      io_chunk.m_parts.push_back( l_part );
+      io_chunk.m_names.push_back( std::make_pair( l_fields[0][0], l_fields[0][1] ) );
+
+      l_line = l_next;
+    }
+  };
+
+  runThreads( l_numChunks, [&]( unsigned int i_c ) { l_parse( l_chunks[i_c] ); } );
+
+  //! Merge chunks in order (material indices are assigned serially)
+  size_t l_total = 0;
+  ID l_lineOffset = 0;
+  for( unsigned int l_c = 0; l_c < l_numChunks; l_c++ ) {
+    if( l_chunks[l_c].m_errLine )
+      return setError( geo::Status::ERR_IMPORT, "Malformed particle on line " +
+                       std::to_string( l_lineOffset + l_chunks[l_c].m_errLine ) );
+
+    l_lineOffset += l_chunks[l_c].m_numLines;
+    l_total      += l_chunks[l_c].m_parts.size();
+  }
+
+  m_importList.reserve( l_total );
+
+  std::string l_lastName;
+  ID l_lastMat = -1;
+
+  for( unsigned int l_c = 0; l_c < l_numChunks; l_c++ ) {
+    Chunk &l_chunk = l_chunks[l_c];
+
+    for( size_t l_i = 0; l_i < l_chunk.m_parts.size(); l_i++ ) {
+      geo::Particle &l_part = l_chunk.m_parts[l_i];
+
+      //! Particles usually come grouped by material
+      if( l_lastMat < 0 ||
+          i_buf.compare( l_chunk.m_names[l_i].first, l_chunk.m_names[l_i].second,
+                         l_lastName ) != 0 ) {
+        l_lastName = i_buf.substr( l_chunk.m_names[l_i].first,
+                                   l_chunk.m_names[l_i].second );
+        l_lastMat  = getMaterial( l_lastName, l_part.m_morph );
+      }
+
+      //! Mismatching morphology within a material fails in getMaterial
+      if( l_lastMat < 0 || m_matList[l_lastMat].m_morph != l_part.m_morph ) {
+        getMaterial( l_lastName, l_part.m_morph );
+        return false;
+      }
+
+      l_part.m_mat = l_lastMat;
+      m_importList.push_back( l_part );
+    }
+  }
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Parse binary particle file (see GeoImport.h for layout; chunks of records
+//! in parallel)
+//! ----------------------------------------------------------------------------
+bool geo::Writer::parseBinParticles( const std::string &i_buf ) {
+  geo::ImportHeader l_header;
+  std::memcpy( &l_header, i_buf.data(), sizeof( l_header ) );
+
+  //! Counts come from the file, so bound them by its size before multiplying
+  size_t l_rest = i_buf.size() - sizeof( l_header );
+  bool l_sized = l_header.m_numMaterials <= l_rest / geo::MANIFEST_NAMELEN;
+  if( l_sized ) {
+    l_rest -= l_header.m_numMaterials * geo::MANIFEST_NAMELEN;
+    l_sized = (l_rest % sizeof( geo::ImportRecord ) == 0) &&
+              (l_header.m_numParticles == l_rest / sizeof( geo::ImportRecord ));
+  }
+
+  if( l_header.m_endian != geo::MANIFEST_ENDIAN ||
+      l_header.m_version != geo::IMPORT_VERSION || !l_sized )
+    return setError( geo::Status::ERR_IMPORT,
+                     "Invalid or truncated binary particle file" );
+
+  uint64_t l_numMats  = l_header.m_numMaterials;
+  uint64_t l_numParts = l_header.m_numParticles;
+  const char *l_names = i_buf.data() + sizeof( l_header );
+  const char *l_recs  = l_names + l_numMats * geo::MANIFEST_NAMELEN;
+
+  //! Per-chunk parse results: first record of every material in the chunk
+  //! (in record order) and the record the chunk stopped at, if any
+  struct Chunk {
+    uint64_t m_begin, m_end, m_stop;
+    bool     m_mixed;
+
+    std::vector< std::pair< uint32_t, uint64_t > > m_firsts;
+
+    Chunk() : m_begin(0), m_end(0), m_stop(0), m_mixed(false) {}
+  };
+
+  unsigned int l_numChunks = numThreads();
+  std::vector< Chunk > l_chunks( l_numChunks );
+
+  m_importList.resize( l_numParts );
+
+  runThreads( l_numChunks, [&]( unsigned int i_c ) {
+    Chunk &l_chunk = l_chunks[i_c];
+    l_chunk.m_begin = i_c * l_numParts / l_numChunks;
+    l_chunk.m_end   = (i_c + 1) * l_numParts / l_numChunks;
+    l_chunk.m_stop  = l_chunk.m_end;
+
+    //! Morphology of each material in the chunk (-1: not seen yet)
+    std::vector< signed char > l_morphs( l_numMats, -1 );
+
+    for( uint64_t l_i = l_chunk.m_begin; l_i < l_chunk.m_end; l_i++ ) {
+      geo::ImportRecord l_rec;
+      std::memcpy( &l_rec, l_recs + l_i * sizeof( l_rec ), sizeof( l_rec ) );
+
+      if( l_rec.m_material >= l_numMats || l_rec.m_morph > 1 ||
+          l_rec.m_rad <= 0.0 ||
+          (!l_rec.m_morph && l_rec.m_cp[0] == l_rec.m_cp[3] &&
+           l_rec.m_cp[1] == l_rec.m_cp[4] && l_rec.m_cp[2] == l_rec.m_cp[5]) ) {
+        l_chunk.m_stop = l_i;
+        return;
+      }
+
+      signed char &l_morph = l_morphs[l_rec.m_material];
+      if( l_morph < 0 ) {
+        l_morph = (signed char) l_rec.m_morph;
+        l_chunk.m_firsts.push_back( std::make_pair( l_rec.m_material, l_i ) );
+      } else if( l_morph != (signed char) l_rec.m_morph ) {
+        l_chunk.m_stop  = l_i;
+        l_chunk.m_mixed = true;
+        return;
+      }
+
+      //! Material holds the name table index until the merge below
+      geo::Particle &l_part = m_importList[l_i];
+      l_part.m_mat   = l_rec.m_material;
+      l_part.m_morph = l_rec.m_morph ? geo::Morph::SPHERE : geo::Morph::CYLINDER;
+      l_part.m_rad   = l_rec.m_rad;
+      l_part.m_A     = geo::Vector( l_rec.m_cp[0], l_rec.m_cp[1], l_rec.m_cp[2] );
+      l_part.m_B     = l_rec.m_morph ? l_part.m_A :
+                       geo::Vector( l_rec.m_cp[3], l_rec.m_cp[4], l_rec.m_cp[5] );
+    }
+  } );
+
+  //! Merge chunks in order: materials are created (morphology from their
+  //! first record) and errors reported as a serial pass would
+  std::vector< ID > l_matIdx( l_numMats, -1 );
+
+  for( unsigned int l_c = 0; l_c < l_numChunks; l_c++ ) {
+    const Chunk &l_chunk = l_chunks[l_c];
+
+    for( size_t l_f = 0; l_f < l_chunk.m_firsts.size(); l_f++ ) {
+      uint32_t   l_mat   = l_chunk.m_firsts[l_f].first;
+      geo::Morph l_morph = m_importList[l_chunk.m_firsts[l_f].second].m_morph;
+
+      if( l_matIdx[l_mat] < 0 ) {
+        const char *l_name = l_names + l_mat * geo::MANIFEST_NAMELEN;
+        l_matIdx[l_mat] = getMaterial( std::string( l_name,
+                                                    strnlen( l_name, geo::MANIFEST_NAMELEN ) ),
+                                       l_morph );
+        if( l_matIdx[l_mat] < 0 )
+          return false;
+      } else if( m_matList[l_matIdx[l_mat]].m_morph != l_morph )
+        return setError( geo::Status::ERR_IMPORT, "Mixed morphologies for " +
+                         m_matList[l_matIdx[l_mat]].m_name );
+    }
+
+    if( l_chunk.m_stop == l_chunk.m_end )
+      continue;
+
+    if( !l_chunk.m_mixed )
+      return setError( geo::Status::ERR_IMPORT, "Malformed particle record " +
+                       std::to_string( l_chunk.m_stop + 1 ) );
+
+    uint32_t l_mat;
+    std::memcpy( &l_mat, l_recs + l_chunk.m_stop * sizeof( geo::ImportRecord ),
+                 sizeof( l_mat ) );
+    return setError( geo::Status::ERR_IMPORT, "Mixed morphologies for " +
+                     m_matList[l_matIdx[l_mat]].m_name );
+  }
+
+  //! Name table indices to material list indices
+  runThreads( l_numChunks, [&]( unsigned int i_c ) {
+    for( uint64_t l_i = l_chunks[i_c].m_begin; l_i < l_chunks[i_c].m_end; l_i++ )
+      m_importList[l_i].m_mat = l_matIdx[m_importList[l_i].m_mat];
+  } );
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Validate imported particles against bounds and each other (uniform grid)
+//! ----------------------------------------------------------------------------
+bool geo::Writer::validateParticles() {
+  size_t l_num = m_importList.size();
+  if( !l_num )
+    return true;
+
+  //! Bounding boxes (inflated by half the tolerance for overlap queries)
+  std::vector< geo::Vector > l_min( l_num ), l_max( l_num );
+  real l_meanExt = 0.0;
+  ID l_outOfBounds = 0, l_firstOut = -1;
+
+  for( size_t l_i = 0; l_i < l_num; l_i++ ) {
+    getBounds( m_importList[l_i], l_min[l_i], l_max[l_i] );
+
+    //! Same clearance to the boundaries as random insertion
+    if( outOfBounds( { l_min[l_i], l_max[l_i] } ) ) {
+      if( !l_outOfBounds++ )
+        l_firstOut = l_i;
+    }
+
+    l_min[l_i] = geo::Vector( l_min[l_i].m_x - 0.5 * m_tolParticles,
+                              l_min[l_i].m_y - 0.5 * m_tolParticles,
+                              l_min[l_i].m_z - 0.5 * m_tolParticles );
+    l_max[l_i] = geo::Vector( l_max[l_i].m_x + 0.5 * m_tolParticles,
+                              l_max[l_i].m_y + 0.5 * m_tolParticles,
+                              l_max[l_i].m_z + 0.5 * m_tolParticles );
+
+    l_meanExt += std::max( l_max[l_i].m_x - l_min[l_i].m_x,
+                 std::max( l_max[l_i].m_y - l_min[l_i].m_y,
+                           l_max[l_i].m_z - l_min[l_i].m_z ) );
+  }
+
+  if( l_outOfBounds )
+    return setError( geo::Status::ERR_IMPORT, std::to_string( l_outOfBounds ) +
+                     " particle(s) out of bounds (first is particle " +
+                     std::to_string( l_firstOut + 1 ) + ")" );
+
+  //! Grid with cells of about the mean particle size (at most ~8 cells per particle)
+  real l_height = m_height - m_pistonThicc;
+  real l_cell   = std::max( l_meanExt / l_num,
+                            std::cbrt( m_length * m_width * l_height / (8.0 * l_num) ) );
+  ID l_dim[3]   = { std::max( (ID) 1, (ID) ceil( m_length / l_cell ) ),
+                    std::max( (ID) 1, (ID) ceil( m_width  / l_cell ) ),
+                    std::max( (ID) 1, (ID) ceil( l_height / l_cell ) ) };
+
+  auto l_cellOf = [&]( const real &i_val, int i_axis ) {
+    return std::min( std::max( (ID) floor( i_val / l_cell ), (ID) 0 ), l_dim[i_axis] - 1 );
+  };
+
+  //! Cell range of each particle
+  std::vector< ID > l_range( 6 * l_num );
+  for( size_t l_i = 0; l_i < l_num; l_i++ ) {
+    l_range[6 * l_i + 0] = l_cellOf( l_min[l_i].m_x, 0 );
+    l_range[6 * l_i + 1] = l_cellOf( l_min[l_i].m_y, 1 );
+    l_range[6 * l_i + 2] = l_cellOf( l_min[l_i].m_z, 2 );
+    l_range[6 * l_i + 3] = l_cellOf( l_max[l_i].m_x, 0 );
+    l_range[6 * l_i + 4] = l_cellOf( l_max[l_i].m_y, 1 );
+    l_range[6 * l_i + 5] = l_cellOf( l_max[l_i].m_z, 2 );
+  }
+
+  //! Compressed cell lists (count, prefix sum, fill)
+  std::vector< ID > l_cellStart( l_dim[0] * l_dim[1] * l_dim[2] + 1, 0 );
+
+  for( size_t l_i = 0; l_i < l_num; l_i++ )
+    for( ID l_z = l_range[6 * l_i + 2]; l_z <= l_range[6 * l_i + 5]; l_z++ )
+      for( ID l_y = l_range[6 * l_i + 1]; l_y <= l_range[6 * l_i + 4]; l_y++ )
+        for( ID l_x = l_range[6 * l_i + 0]; l_x <= l_range[6 * l_i + 3]; l_x++ )
+          l_cellStart[(l_z * l_dim[1] + l_y) * l_dim[0] + l_x + 1]++;
+
+  for( size_t l_c = 1; l_c < l_cellStart.size(); l_c++ )
+    l_cellStart[l_c] += l_cellStart[l_c - 1];
+
+  std::vector< ID > l_cellParts( l_cellStart.back() );
+  std::vector< ID > l_fill( l_cellStart.begin(), l_cellStart.end() - 1 );
+
+  for( size_t l_i = 0; l_i < l_num; l_i++ )
+    for( ID l_z = l_range[6 * l_i + 2]; l_z <= l_range[6 * l_i + 5]; l_z++ )
+      for( ID l_y = l_range[6 * l_i + 1]; l_y <= l_range[6 * l_i + 4]; l_y++ )
+        for( ID l_x = l_range[6 * l_i + 0]; l_x <= l_range[6 * l_i + 3]; l_x++ )
+          l_cellParts[l_fill[(l_z * l_dim[1] + l_y) * l_dim[0] + l_x]++] = l_i;
+
+  //! Test candidate pairs in parallel (each pair only in the cell holding the
+  //! lower corner of the overlap of both boxes)
+  unsigned int l_numThreads = numThreads();
+  std::vector< ID > l_collisions( l_numThreads, 0 );
+  std::vector< std::pair< ID, ID > > l_first( l_numThreads, std::make_pair( -1, -1 ) );
+
+  auto l_check = [&]( unsigned int i_t ) {
+    for( size_t l_i = i_t; l_i < l_num; l_i += l_numThreads ) {
+      for( ID l_z = l_range[6 * l_i + 2]; l_z <= l_range[6 * l_i + 5]; l_z++ )
+      for( ID l_y = l_range[6 * l_i + 1]; l_y <= l_range[6 * l_i + 4]; l_y++ )
+      for( ID l_x = l_range[6 * l_i + 0]; l_x <= l_range[6 * l_i + 3]; l_x++ ) {
+        ID l_c = (l_z * l_dim[1] + l_y) * l_dim[0] + l_x;
+
+        for( ID l_k = l_cellStart[l_c]; l_k < l_cellStart[l_c + 1]; l_k++ ) {
+          size_t l_j = l_cellParts[l_k];
+          if( l_j <= l_i )
+            continue;
+
+          //! Boxes must overlap
+          if( l_min[l_i].m_x > l_max[l_j].m_x || l_min[l_j].m_x > l_max[l_i].m_x ||
+              l_min[l_i].m_y > l_max[l_j].m_y || l_min[l_j].m_y > l_max[l_i].m_y ||
+              l_min[l_i].m_z > l_max[l_j].m_z || l_min[l_j].m_z > l_max[l_i].m_z )
+            continue;
+
+          //! Deduplicate pairs sharing several cells
+          if( l_x != std::max( l_range[6 * l_i + 0], l_range[6 * l_j + 0] ) ||
+              l_y != std::max( l_range[6 * l_i + 1], l_range[6 * l_j + 1] ) ||
+              l_z != std::max( l_range[6 * l_i + 2], l_range[6 * l_j + 2] ) )
+            continue;
+
+          if( particlesCollide( m_importList[l_i], m_importList[l_j], m_tolParticles ) ) {
+            if( !l_collisions[i_t]++ )
+              l_first[i_t] = std::make_pair( l_i, l_j );
+          }
+        }
+      }
+    }
+  };
+
+  runThreads( l_numThreads, l_check );
+
+  ID l_total = 0;
+  std::pair< ID, ID > l_pair( -1, -1 );
+  for( unsigned int l_t = 0; l_t < l_numThreads; l_t++ ) {
+    if( l_collisions[l_t] && (l_pair.first < 0 || l_first[l_t] < l_pair) )
+      l_pair = l_first[l_t];
+    l_total += l_collisions[l_t];
+  }
+
+  if( l_total )
+    return setError( geo::Status::ERR_IMPORT, std::to_string( l_total ) +
+                     " colliding particle pair(s) (first are particles " +
+                     std::to_string( l_pair.first + 1 ) + " and " +
+                     std::to_string( l_pair.second + 1 ) + ")" );
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Import particles from CSV or binary buffer (replaces random insertion)
+//! ----------------------------------------------------------------------------
+geo::Status geo::Writer::importParticles( const std::string &i_buf ) {
+  if( m_status != geo::Status::SUCCESS )
+    return m_status;
+
+  //! Start time
+  clock_t l_time = clock();
+
+  if( m_log )
+    *m_log << "Importing particles.. " << std::flush;
+
+  m_import = true;
+
+  bool l_ok;
+  if( i_buf.size() >= sizeof( geo::ImportHeader ) &&
+      std::equal( geo::IMPORT_MAGIC, geo::IMPORT_MAGIC + 8, i_buf.data() ) )
+    l_ok = parseBinParticles( i_buf );
+  else
+    l_ok = parseCsvParticles( i_buf );
+
+  if( !l_ok || !validateParticles() )
+    return m_status;
+
+  //! End time
+  l_time = clock() - l_time;
+  if( m_log )
+    *m_log << m_importList.size() << " particles. Done! ("
+           << (float) l_time / CLOCKS_PER_SEC << "s)\n";
+
+  return m_status;
+}
+
+//! ----------------------------------------------------------------------------
+//! Import particles from CSV or binary file
+//! ----------------------------------------------------------------------------
+geo::Status geo::Writer::importParticles( const char *i_filename ) {
+  std::ifstream l_in( i_filename, std::ios::in | std::ios::binary );
+  if( !l_in.is_open() ) {
+    setError( geo::Status::ERR_IO, std::string( "Cannot open " ) + i_filename );
+    return m_status;
+  }
+
+  //! Slurp whole file
+  std::string l_buf;
+  l_in.seekg( 0, std::ios::end );
+  l_buf.resize( l_in.tellg() );
+  l_in.seekg( 0, std::ios::beg );
+  l_in.read( &l_buf[0], l_buf.size() );
+  l_in.close();
+
+  return importParticles( l_buf );
+}
+
+//! ----------------------------------------------------------------------------
+//! Write imported particles material by material
+//! ----------------------------------------------------------------------------
+void geo::Writer::writeImportedMaterials() {
+  //! Order particles by material (stable, keeps file order within material)
+  std::vector< ID > l_start( m_matList.size() + 1, 0 );
+  std::vector< geo::Particle >::const_iterator l_it;
+
+  for( l_it = m_importList.begin(); l_it != m_importList.end(); ++l_it )
+    l_start[l_it->m_mat + 1]++;
+  for( size_t l_m = 1; l_m < l_start.size(); l_m++ )
+    l_start[l_m] += l_start[l_m - 1];
+
+  std::vector< ID > l_order( m_importList.size() );
+  std::vector< ID > l_fill( l_start.begin(), l_start.end() - 1 );
+  for( size_t l_i = 0; l_i < m_importList.size(); l_i++ )
+    l_order[l_fill[m_importList[l_i].m_mat]++] = l_i;
+
+  //! Cylinder axis (always toward +ve x-axis)
+  geo::Vector l_cylAxis( 1.0, 0.0, 0.0 );
+
+  for( size_t l_m = 0; l_m < m_matList.size(); l_m++ ) {
+    geo::Material *l_mat = &m_matList[l_m];
+
+    //! Assign material mesh size to global mesh size if not specified by user
+    if( !l_mat->m_meshSize )
+      l_mat->m_meshSize = m_meshSize;
+
+    if( m_log )
+      *m_log << l_mat->m_name << ": " << l_start[l_m + 1] - l_start[l_m]
+             << (l_mat->m_morph == geo::Morph::CYLINDER ? " cyl" : " sph")
+             << std::endl;
+
+    for( ID l_k = l_start[l_m]; l_k < l_start[l_m + 1]; l_k++ ) {
+      const geo::Particle &l_part = m_importList[l_order[l_k]];
+
+      if( l_part.m_morph == geo::Morph::SPHERE ) {
+        writeSphere( l_mat, l_part.m_A, l_part.m_rad );
+        continue;
+      }
+
+      //! Keep axis in +ve x half-space so rotation from x-axis is defined
+      geo::Vector l_A( l_part.m_A ), l_B( l_part.m_B );
+      if( l_B.m_x < l_A.m_x )
+        std::swap( l_A, l_B );
+
+      geo::Vector l_axis( l_A, l_B );
+      real l_len = geo::norm( l_axis );
+      l_axis = geo::Vector( l_axis.m_x / l_len, l_axis.m_y / l_len,
+                            l_axis.m_z / l_len );
+
+      geo::Vector l_cP[10];
+      getCylinderPoints( l_A, geo::getRotMat( l_cylAxis, l_axis ),
+                         l_part.m_rad, l_len, l_cP );
+
+      writeCylinder( l_mat, l_cP, l_part.m_rad );
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Particle import formats for GeoGen.
+ *
+ * CSV: one particle per line (lines starting with '#' and a leading
+ *   "material,..." header line are skipped)
+ *     material,cyl,radius,x1,y1,z1,x2,y2,z2
+ *     material,sph,radius,x,y,z
+ *
+ * Binary (native byte order, checked against the header marker):
+ *   ImportHeader
+ *   char name[m_numMaterials][MANIFEST_NAMELEN]
+ *   ImportRecord[m_numParticles]
+ **/
+
+#ifndef GEO_IMPORT_H
+#define GEO_IMPORT_H
+
+#include "Geo.hpp"
+#include "GeoManifest.h"
+
+namespace geo {
+  struct Particle;
+  struct ImportHeader;
+  struct ImportRecord;
+
+  //! Magic and version of the binary particle file
+  const char     IMPORT_MAGIC[8] = { 'G', 'E', 'O', 'P', 'R', 'T', '\0', '\0' };
+  const uint32_t IMPORT_VERSION  = 1;
+}
+
+//! ----------------------------------------------------------------------------
+//! Imported particle data-structure
+//! ----------------------------------------------------------------------------
+struct geo::Particle {
+  //! Index into material list
+  ID          m_mat;
+  Morph       m_morph;
+  real        m_rad;
+
+  //! End points of cylinder axis (A == B is the center for sphere)
+  geo::Vector m_A, m_B;
+
+  Particle() : m_mat(0), m_morph(Morph::SPHERE), m_rad(0.0) {}
+};
+
+//! ----------------------------------------------------------------------------
+//! Binary particle file header
+//! ----------------------------------------------------------------------------
+struct geo::ImportHeader {
+  char     m_magic[8];
+  uint32_t m_version;
+  uint32_t m_endian;
+  uint64_t m_numMaterials;
+  uint64_t m_numParticles;
+};
+
+//! ----------------------------------------------------------------------------
+//! Binary particle record
+//! ----------------------------------------------------------------------------
+struct geo::ImportRecord {
+  //! Index into the name table
+  uint32_t m_material;
+
+  //! 0 for cylinder, 1 for sphere
+  uint32_t m_morph;
+
+  real     m_rad;
+
+  //! x1 y1 z1 x2 y2 z2 for cylinder, x y z (rest unused) for sphere
+  real     m_cp[6];
+};
+
+static_assert( sizeof( geo::ImportHeader ) == 32, "Unexpected header padding" );
+static_assert( sizeof( geo::ImportRecord ) == 64, "Unexpected record padding" );
+
+#endif
\ No newline at end of file
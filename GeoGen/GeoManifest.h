@@ -0,0 +1,90 @@
+/**
+ * @file This file is part of MeshGen.
+ *
+ * @section LICENSE
+ * MIT License
+ *
+ * Copyright (c) 2018 Rajdeep Konwar
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Binary material manifest format shared by GeoGen and EurekaGen.
+ *
+ * Layout (all offsets in bytes from the start of the file, 8-byte aligned):
+ *   ManifestHeader
+ *   ManifestMaterial[m_numMaterials]
+ *   per material: real radius[m_numParticles]
+ *                 real controlPoints[m_numParticles * m_cpStride]
+ **/
+
+#ifndef GEO_MANIFEST_H
+#define GEO_MANIFEST_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GeoConstants.h"
+
+namespace geo {
+  struct ManifestHeader;
+  struct ManifestMaterial;
+
+  //! Magic, version and byte-order marker of the manifest
+  const char     MANIFEST_MAGIC[8] = { 'G', 'E', 'O', 'M', 'A', 'T', '\0', '\0' };
+  const uint32_t MANIFEST_VERSION  = 1;
+  const uint32_t MANIFEST_ENDIAN   = 0x01020304;
+
+  //! Maximum length (including terminator) of a material name
+  const size_t   MANIFEST_NAMELEN  = 64;
+}
+
+//! ----------------------------------------------------------------------------
+//! Manifest header
+//! ----------------------------------------------------------------------------
+struct geo::ManifestHeader {
+  char     m_magic[8];
+  uint32_t m_version;
+  uint32_t m_endian;
+  uint64_t m_numMaterials;
+  uint64_t m_fileSize;
+};
+
+//! ----------------------------------------------------------------------------
+//! Manifest material table entry
+//! ----------------------------------------------------------------------------
+struct geo::ManifestMaterial {
+  char     m_name[MANIFEST_NAMELEN];
+
+  //! 0 for cylinder, 1 for sphere (see geo::Morph)
+  uint32_t m_morph;
+
+  //! Control point reals per particle (6 for cylinder, 3 for sphere)
+  uint32_t m_cpStride;
+
+  uint64_t m_numParticles;
+  uint64_t m_radOffset;
+  uint64_t m_cpOffset;
+};
+
+static_assert( sizeof( real ) == 8, "Manifest stores 8-byte reals" );
+static_assert( sizeof( geo::ManifestHeader ) == 32, "Unexpected header padding" );
+static_assert( sizeof( geo::ManifestMaterial ) == 96, "Unexpected table padding" );
+
+#endif
\ No newline at end of file
@@ -28,6 +28,8 @@
  * Core math and vector calculus functions.
  **/
 
+#include <algorithm>
+
 #include "Geo.hpp"
 
 //! ----------------------------------------------------------------------------
@@ -101,6 +103,73 @@ geo::Vector geo::unitcross( const geo::Vector &i_vec1,
   return l_prod;
 }
 
+//! ----------------------------------------------------------------------------
+//! Distance of point P from line segment AB
+//! ----------------------------------------------------------------------------
+real geo::distPointSegment( const geo::Vector &i_P,
+                            const geo::Vector &i_A,
+                            const geo::Vector &i_B ) {
+  geo::Vector l_AB( i_A, i_B );
+  geo::Vector l_AP( i_A, i_P );
+
+  real l_len2 = geo::dot( l_AB, l_AB );
+  real l_t    = (l_len2 > 0.0) ? geo::dot( l_AP, l_AB ) / l_len2 : 0.0;
+
+  //! Clamp projection onto segment
+  l_t = std::min( std::max( l_t, 0.0 ), 1.0 );
+
+  return geo::dist( i_P, geo::Vector( i_A.m_x + l_t * l_AB.m_x,
+                                      i_A.m_y + l_t * l_AB.m_y,
+                                      i_A.m_z + l_t * l_AB.m_z ) );
+}
+
+//! ----------------------------------------------------------------------------
+//! Shortest distance between line segments A1B1 and A2B2
+//! ----------------------------------------------------------------------------
+real geo::distSegments( const geo::Vector &i_A1,
+                        const geo::Vector &i_B1,
+                        const geo::Vector &i_A2,
+                        const geo::Vector &i_B2 ) {
+  geo::Vector l_d1( i_A1, i_B1 );
+  geo::Vector l_d2( i_A2, i_B2 );
+  geo::Vector l_r( i_A2, i_A1 );
+
+  real l_a = geo::dot( l_d1, l_d1 );
+  real l_e = geo::dot( l_d2, l_d2 );
+  real l_f = geo::dot( l_d2, l_r );
+
+  //! Degenerate segments
+  if( l_a <= 0.0 )
+    return geo::distPointSegment( i_A1, i_A2, i_B2 );
+  if( l_e <= 0.0 )
+    return geo::distPointSegment( i_A2, i_A1, i_B1 );
+
+  real l_b = geo::dot( l_d1, l_d2 );
+  real l_c = geo::dot( l_d1, l_r );
+  real l_denom = l_a * l_e - l_b * l_b;
+
+  //! Closest point parameters s (on 1st) and t (on 2nd), parallel => s = 0
+  real l_s = (l_denom > 0.0) ?
+             std::min( std::max( (l_b * l_f - l_c * l_e) / l_denom, 0.0 ), 1.0 ) :
+             0.0;
+  real l_t = (l_b * l_s + l_f) / l_e;
+
+  if( l_t < 0.0 ) {
+    l_t = 0.0;
+    l_s = std::min( std::max( -l_c / l_a, 0.0 ), 1.0 );
+  } else if( l_t > 1.0 ) {
+    l_t = 1.0;
+    l_s = std::min( std::max( (l_b - l_c) / l_a, 0.0 ), 1.0 );
+  }
+
+  return geo::dist( geo::Vector( i_A1.m_x + l_s * l_d1.m_x,
+                                 i_A1.m_y + l_s * l_d1.m_y,
+                                 i_A1.m_z + l_s * l_d1.m_z ),
+                    geo::Vector( i_A2.m_x + l_t * l_d2.m_x,
+                                 i_A2.m_y + l_t * l_d2.m_y,
+                                 i_A2.m_z + l_t * l_d2.m_z ) );
+}
+
 //! ----------------------------------------------------------------------------
 //! Get rotation matrix
 //! ----------------------------------------------------------------------------
@@ -28,68 +28,58 @@
  * Writer and helper functions for GeoGen.
  **/
 
+#include <algorithm>
 #include <chrono>
 #include <ctime>
-#include <random>
 
 #include "GeoWriter.h"
 
-//! ----------------------------------------------------------------------------
-//! Randomizer
-//! ----------------------------------------------------------------------------
-template< typename T >
-inline T randomizer( const T &i_low,
-                     const T &i_high ) {
-  return (static_cast< T >(rand()) /
-          static_cast< T >(RAND_MAX / (i_high - i_low)) + i_low);
-}
-
 //! ----------------------------------------------------------------------------
 //! Constructor
 //! ----------------------------------------------------------------------------
-geo::Writer::Writer( const char* i_filename ) : m_time(clock()),
-                                                m_pointID(1),
-                                                m_lineID(1),
-                                                m_lineLoopID(1),
-                                                m_surfaceID(1),
-                                                m_surfaceLoopID(3),
-                                                m_length(10000.0),
-                                                m_width(5000.0),
-                                                m_height(5500.0),
-                                                m_meshSize(200.0),
-                                                m_tolParticles(50.0),
-                                                m_tolPartBound(50.0),
-                                                m_pistonThicc(500.0),
-                                                m_seed(0) {
-  m_out.open( i_filename, std::ofstream::out );
-  if( !m_out.is_open() ) {
-    std::cerr << "Couldn't open " << i_filename << "! Exiting..\n";
-    exit( EXIT_FAILURE );
+geo::Writer::Writer( const geo::Config &i_config,
+                     std::ostream      &o_geo,
+                     std::ostream      &o_mat,
+                     std::ostream      *o_log ) : m_pointID(1),
+                                                  m_lineID(1),
+                                                  m_lineLoopID(1),
+                                                  m_surfaceID(1),
+                                                  m_surfaceLoopID(3),
+                                                  m_length(i_config.m_length),
+                                                  m_width(i_config.m_width),
+                                                  m_height(i_config.m_height),
+                                                  m_meshSize(i_config.m_meshSize),
+                                                  m_tolParticles(i_config.m_tolParticles),
+                                                  m_tolPartBound(i_config.m_tolPartBound),
+                                                  m_pistonThicc(i_config.m_pistonThicc),
+                                                  m_seed(i_config.m_seed),
+                                                  m_out(o_geo),
+                                                  m_mat(o_mat),
+                                                  m_log(o_log),
+                                                  m_status(geo::Status::SUCCESS),
+                                                  m_matList(i_config.m_matList),
+                                                  m_import(false) {}
+
+//! ----------------------------------------------------------------------------
+//! Record the first error
+//! ----------------------------------------------------------------------------
+bool geo::Writer::setError( const geo::Status &i_status,
+                            const std::string &i_error ) {
+  if( m_status == geo::Status::SUCCESS ) {
+    m_status = i_status;
+    m_error  = i_error;
   }
 
-  m_mat.open( "GeoGen.mat", std::ofstream::out );
-  if( !m_mat.is_open() ) {
-    std::cerr << "Couldn't open GeoGen.mat! Exiting..\n";
-    exit( EXIT_FAILURE );
-  }
+  return false;
 }
 
 //! ----------------------------------------------------------------------------
-//! Destructor
+//! Randomizer
 //! ----------------------------------------------------------------------------
-geo::Writer::~Writer() {
-  //! Close output files
-  m_out.close();
-  m_mat.close();
-
-  //! Delete materials
-  std::vector< geo::Material * >::const_iterator l_it;
-  for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it )
-    delete (*l_it);
-
-  //! Display time taken
-  m_time = clock() - m_time;
-  std::cout << "Done!\nTime taken = " << (float) m_time / CLOCKS_PER_SEC << "s\n";
+inline real geo::Writer::randomizer( const real &i_low,
+                                     const real &i_high ) {
+  return i_low + (i_high - i_low) *
+                 std::uniform_real_distribution< real >( 0.0, 1.0 )( m_rng );
 }
 
 //! ----------------------------------------------------------------------------
@@ -274,22 +264,64 @@ void geo::Writer::writeSurfaceLoops() {
 //! Write all volumes to geo script
 //! ----------------------------------------------------------------------------
 void geo::Writer::writeVolumes() {
+  //! Surface loop 1 already bounds the matrix by the particle surfaces
   for( ID l_i = 1; l_i < m_surfaceLoopID; l_i++ )
     m_out << "Volume(" << l_i << ") = { " << l_i << " };\n";
 }
 
 //! ----------------------------------------------------------------------------
-//! Write a control points to mat file
+//! Write physical surfaces (box faces) to geo script
+//! ----------------------------------------------------------------------------
+void geo::Writer::writePhysicalSurfaces() {
+  //! Plane surfaces 1-11 written by writeBoxAndPiston
+  m_out << "Physical Surface(\"back\") = { 1,2 };\n"
+        << "Physical Surface(\"left\") = { 3,4 };\n"
+        << "Physical Surface(\"front\") = { 5,6 };\n"
+        << "Physical Surface(\"right\") = { 7,8 };\n"
+        << "Physical Surface(\"bottom\") = { 9 };\n"
+        << "Physical Surface(\"top\") = { 10 };\n"
+        << "Physical Surface(\"interface\") = { 11 };\n";
+}
+
+//! ----------------------------------------------------------------------------
+//! Write physical volumes (element groups) to geo script
+//! ----------------------------------------------------------------------------
+void geo::Writer::writePhysicalVolumes() {
+  m_out << "Physical Volume(\"matrix\") = { 1 };\n"
+        << "Physical Volume(\"Piston\") = { 2 };\n";
+
+  std::vector< geo::Material >::const_iterator l_it;
+  for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it ) {
+    const std::vector< ID > &l_vols = l_it->m_volList;
+
+    //! Gmsh does not accept empty physical groups
+    if( l_vols.empty() )
+      continue;
+
+    m_out << "Physical Volume(\"" << l_it->m_name << "\") = { ";
+
+    std::vector< ID >::const_iterator l_volIt;
+    for( l_volIt = l_vols.begin(); l_volIt != l_vols.end(); ++l_volIt )
+      m_out << *l_volIt << ((l_volIt + 1) == l_vols.end() ? "" : ",");
+
+    m_out << " };\n";
+  }
+}
+
+//! ----------------------------------------------------------------------------
+//! Store radius and control points of a particle for the manifest
 //! ----------------------------------------------------------------------------
-void geo::Writer::writeControlPoints( const real                                 &i_rad,
+void geo::Writer::writeControlPoints(       geo::Material                        *i_mat,
+                                      const real                                 &i_rad,
                                       const std::initializer_list< geo::Vector > &i_list ) {
-    m_mat << i_rad;
+    i_mat->m_radList.push_back( i_rad );
 
     std::initializer_list< geo::Vector >::const_iterator l_it;
-    for( l_it = i_list.begin(); l_it != i_list.end(); ++l_it )
-      m_mat << " " << l_it->m_x << " " << l_it->m_y << " " << l_it->m_z;
-
-    m_mat << std::endl;
+    for( l_it = i_list.begin(); l_it != i_list.end(); ++l_it ) {
+      i_mat->m_cpList.push_back( l_it->m_x );
+      i_mat->m_cpList.push_back( l_it->m_y );
+      i_mat->m_cpList.push_back( l_it->m_z );
+    }
 }
 
 //! ----------------------------------------------------------------------------
@@ -300,14 +332,20 @@ void geo::Writer::writeHeader() {
     m_seed = (unsigned) time( nullptr );
 
   //! Seed the randomizer
-  srand( m_seed );
+  m_rng.seed( m_seed );
 
   std::chrono::system_clock::time_point l_p = std::chrono::system_clock::now();
   std::time_t l_t = std::chrono::system_clock::to_time_t( l_p );
 
+  //! Same layout as ctime, but reentrant
+  struct tm l_tm;
+  char l_stamp[32];
+  localtime_r( &l_t, &l_tm );
+  strftime( l_stamp, sizeof( l_stamp ), "%a %b %e %H:%M:%S %Y\n", &l_tm );
+
   m_out << "/** Gmsh geometry script generated by GeoGen (author: Rajdeep Konwar)\n"
         << " *  Copyright (c) 2018, Robert Bosch LLC\n"
-        << " *  Timestamp: " << std::ctime( &l_t )
+        << " *  Timestamp: " << l_stamp
         << " *  Rand seed: " << m_seed << "\n"
         << " **/\n\n";
 
@@ -396,66 +434,45 @@ void geo::Writer::writeBoxAndPiston() {
 }
 
 //! ----------------------------------------------------------------------------
-//! Write cylindrical particle to geo script
-//! ----------------------------------------------------------------------------
-void geo::Writer::writeCylinder( const geo::Material *i_mat ) {
-  m_out << "//! Cylinder\n";
-
-  //! Cylinder control points
-  ID l_cpC1 = m_pointID;       //! Center (left)
-  ID l_cp1  = m_pointID + 1;   //! Bottom (-z)
-  ID l_cp2  = m_pointID + 2;   //! Top    (+z)
-  ID l_cp3  = m_pointID + 3;   //! Rear   (-x)
-  ID l_cp4  = m_pointID + 4;   //! Front  (+x)
-
-  ID l_cpC2 = m_pointID + 5;   //! Center (right)
-  ID l_cp5  = m_pointID + 6;   //! Bottom (-z)
-  ID l_cp6  = m_pointID + 7;   //! Top    (+z)
-  ID l_cp7  = m_pointID + 8;   //! Rear   (-x)
-  ID l_cp8  = m_pointID + 9;   //! Front  (+x)
-
-  //! Circle arc IDs
-  ID l_ca1  = m_lineID;
-  ID l_ca2  = m_lineID + 1;
-  ID l_ca3  = m_lineID + 2;
-  ID l_ca4  = m_lineID + 3;
-  ID l_ca5  = m_lineID + 4;
-  ID l_ca6  = m_lineID + 5;
-  ID l_ca7  = m_lineID + 6;
-  ID l_ca8  = m_lineID + 7;
-
-  //! Lines joining faces
-  ID l_l1   = m_lineID + 8;
-  ID l_l2   = m_lineID + 9;
-  ID l_l3   = m_lineID + 10;
-  ID l_l4   = m_lineID + 11;
-
-  //! Line loop IDs
-  ID l_cll1 = m_lineLoopID;
-  ID l_cll2 = m_lineLoopID + 1;
-  ID l_cll3 = m_lineLoopID + 2;
-  ID l_cll4 = m_lineLoopID + 3;
-  ID l_cll5 = m_lineLoopID + 4;
-  ID l_cll6 = m_lineLoopID + 5;
-
-  //! Populate surface map
-  std::vector< ID > l_vec{ l_cll1, l_cll2, l_cll3, l_cll4, l_cll5, l_cll6 };
-  m_surfMap[m_surfaceLoopID++] = l_vec;
+//! Get the 10 points (face centers and arc end points) of a cylinder at base
+//! i_base rotated by i_rmat from the +ve x-axis
+//! ----------------------------------------------------------------------------
+void geo::Writer::getCylinderPoints( const geo::Vector &i_base,
+                                     const geo::Matrix &i_rmat,
+                                     const real        &i_rad,
+                                     const real        &i_len,
+                                     geo::Vector      (&o_cP)[10] ) {
+  //! Originally, cylinder is at center to ease rotation
+  o_cP[0] = geo::Vector( 0.0,    0.0,    0.0   );
+  o_cP[1] = geo::Vector( 0.0,   -i_rad,  0.0   );
+  o_cP[2] = geo::Vector( 0.0,    i_rad,  0.0   );
+  o_cP[3] = geo::Vector( 0.0,    0.0,   -i_rad );
+  o_cP[4] = geo::Vector( 0.0,    0.0,    i_rad );
+  o_cP[5] = geo::Vector( i_len,  0.0,    0.0   );
+  o_cP[6] = geo::Vector( i_len, -i_rad,  0.0   );
+  o_cP[7] = geo::Vector( i_len,  i_rad,  0.0   );
+  o_cP[8] = geo::Vector( i_len,  0.0,   -i_rad );
+  o_cP[9] = geo::Vector( i_len,  0.0,    i_rad );
+
+  //! New points
+  for( int l_i = 0; l_i < 10; l_i++ )
+    o_cP[l_i] = geo::dot( i_rmat, o_cP[l_i] ) + i_base;
+}
 
+//! ----------------------------------------------------------------------------
+//! Insert cylindrical particle at random
+//! ----------------------------------------------------------------------------
+bool geo::Writer::insertCylinder( geo::Material *i_mat ) {
   //! Cylinder axis (always toward +ve x-axis)
   geo::Vector l_cylAxis( 1.0, 0.0, 0.0 );
 
   //! Points on cylinder
-  geo::Vector l_cP1, l_cP2, l_cP3, l_cP4, l_cP5,
-              l_cP6, l_cP7, l_cP8, l_cP9, l_cP10, l_rAxis;
+  geo::Vector l_cP[10], l_rAxis;
 
   geo::Cylinder l_cyl;
   ID l_count = 0;
   real l_rad = 100.0, l_len = 1000.0;
 
-  //! Seed the Gaussian random generator
-  std::default_random_engine l_generator( m_seed );
-
   real l_meanRad = (i_mat->m_radMean ? i_mat->m_radMean :
                                     ((i_mat->m_radMin + i_mat->m_radMax) / 2.0));
   real l_meanLen = (i_mat->m_lenMean ? i_mat->m_lenMean :
@@ -469,90 +486,112 @@ void geo::Writer::writeCylinder( const geo::Material *i_mat ) {
     //! Randomize radius
     switch( i_mat->m_radDistrib ) {
       case geo::Distrib::GAUSSIAN:
-        l_rad = l_distribRad( l_generator );
+        l_rad = l_distribRad( m_rng );
         break;
       case geo::Distrib::UNIFORM:
-        l_rad = randomizer< real >( i_mat->m_radMin, i_mat->m_radMax );
+        l_rad = randomizer( i_mat->m_radMin, i_mat->m_radMax );
         break;
     }
 
     //! Randomize length
     switch( i_mat->m_lenDistrib ) {
       case geo::Distrib::GAUSSIAN:
-        l_len = l_distribLen( l_generator );
+        l_len = l_distribLen( m_rng );
         break;
       case geo::Distrib::UNIFORM:
-        l_len = randomizer< real >( i_mat->m_lenMin, i_mat->m_lenMax );
+        l_len = randomizer( i_mat->m_lenMin, i_mat->m_lenMax );
         break;
     }
 
-    //! Originally, cylinder is at center to ease rotation
-    l_cP1   = geo::Vector( 0.0,    0.0,    0.0   );
-    l_cP2   = geo::Vector( 0.0,   -l_rad,  0.0   );
-    l_cP3   = geo::Vector( 0.0,    l_rad,  0.0   );
-    l_cP4   = geo::Vector( 0.0,    0.0,   -l_rad );
-    l_cP5   = geo::Vector( 0.0,    0.0,    l_rad );
-    l_cP6   = geo::Vector( l_len,  0.0,    0.0   );
-    l_cP7   = geo::Vector( l_len, -l_rad,  0.0   );
-    l_cP8   = geo::Vector( l_len,  l_rad,  0.0   );
-    l_cP9   = geo::Vector( l_len,  0.0,   -l_rad );
-    l_cP10  = geo::Vector( l_len,  0.0,    l_rad );
-
     //! (Random) Axis to be rotated to
-    l_rAxis = geo::Vector( randomizer< real >( -1.0, 1.0 ),
-                           randomizer< real >( -1.0, 1.0 ),
-                           randomizer< real >( -1.0, 1.0 ) );
+    l_rAxis = geo::Vector( randomizer( -1.0, 1.0 ),
+                           randomizer( -1.0, 1.0 ),
+                           randomizer( -1.0, 1.0 ) );
 
     //! Get rotation matrix
     geo::Matrix l_rmat = geo::getRotMat( l_cylAxis, l_rAxis );
 
     //! Random translations
-    geo::Vector l_cB( randomizer< real >( 0.0, m_length ),
-                      randomizer< real >( 0.0, m_width  ),
-                      randomizer< real >( 0.0, m_height ) );
-
-    //! New points
-    l_cP1   = geo::dot( l_rmat, l_cP1  ) + l_cB;
-    l_cP2   = geo::dot( l_rmat, l_cP2  ) + l_cB;
-    l_cP3   = geo::dot( l_rmat, l_cP3  ) + l_cB;
-    l_cP4   = geo::dot( l_rmat, l_cP4  ) + l_cB;
-    l_cP5   = geo::dot( l_rmat, l_cP5  ) + l_cB;
-    l_cP6   = geo::dot( l_rmat, l_cP6  ) + l_cB;
-    l_cP7   = geo::dot( l_rmat, l_cP7  ) + l_cB;
-    l_cP8   = geo::dot( l_rmat, l_cP8  ) + l_cB;
-    l_cP9   = geo::dot( l_rmat, l_cP9  ) + l_cB;
-    l_cP10  = geo::dot( l_rmat, l_cP10 ) + l_cB;
-
-    l_cyl = geo::Cylinder( l_cP1, l_rAxis, l_rad, l_len );
+    geo::Vector l_cB( randomizer( 0.0, m_length ),
+                      randomizer( 0.0, m_width  ),
+                      randomizer( 0.0, m_height ) );
+
+    getCylinderPoints( l_cB, l_rmat, l_rad, l_len, l_cP );
+
+    l_cyl = geo::Cylinder( l_cP[0], l_rAxis, l_rad, l_len );
 
     //! Infinite loop breaker
-    if( l_count++ >= ITERLIM ) {
-      std::cerr << "Reached limit for iterative cylinder insertion! Exiting..\n";
-      m_out.close();
-      m_mat.close();
-      exit( EXIT_FAILURE );
-    }
-  } while( outOfBounds( { l_cP1, l_cP2, l_cP3, l_cP4, l_cP5,
-                          l_cP6, l_cP7, l_cP8, l_cP9, l_cP10 } ) ||
+    if( l_count++ >= ITERLIM )
+      return setError( geo::Status::ERR_INSERTION,
+                       "Reached limit for iterative cylinder insertion" );
+  } while( outOfBounds( { l_cP[0], l_cP[1], l_cP[2], l_cP[3], l_cP[4],
+                          l_cP[5], l_cP[6], l_cP[7], l_cP[8], l_cP[9] } ) ||
            collisionDetection( l_cyl ) );
 
   //! Store newly inserted cylinder info (for collision detection)
   m_cylList.push_back( l_cyl );
 
-  //! Write out control points to mat file
-  writeControlPoints( l_rad, { l_cP1, l_cP6 } );
+  writeCylinder( i_mat, l_cP, l_rad );
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Write cylindrical particle (given by its 10 points) to geo script
+//! ----------------------------------------------------------------------------
+void geo::Writer::writeCylinder(       geo::Material *i_mat,
+                                 const geo::Vector  (&i_cP)[10],
+                                 const real          &i_rad ) {
+  m_out << "//! Cylinder\n";
+
+  //! Cylinder control points
+  ID l_cpC1 = m_pointID;       //! Center (left)
+  ID l_cp1  = m_pointID + 1;   //! Bottom (-z)
+  ID l_cp2  = m_pointID + 2;   //! Top    (+z)
+  ID l_cp3  = m_pointID + 3;   //! Rear   (-x)
+  ID l_cp4  = m_pointID + 4;   //! Front  (+x)
+
+  ID l_cpC2 = m_pointID + 5;   //! Center (right)
+  ID l_cp5  = m_pointID + 6;   //! Bottom (-z)
+  ID l_cp6  = m_pointID + 7;   //! Top    (+z)
+  ID l_cp7  = m_pointID + 8;   //! Rear   (-x)
+  ID l_cp8  = m_pointID + 9;   //! Front  (+x)
+
+  //! Circle arc IDs
+  ID l_ca1  = m_lineID;
+  ID l_ca2  = m_lineID + 1;
+  ID l_ca3  = m_lineID + 2;
+  ID l_ca4  = m_lineID + 3;
+  ID l_ca5  = m_lineID + 4;
+  ID l_ca6  = m_lineID + 5;
+  ID l_ca7  = m_lineID + 6;
+  ID l_ca8  = m_lineID + 7;
+
+  //! Lines joining faces
+  ID l_l1   = m_lineID + 8;
+  ID l_l2   = m_lineID + 9;
+  ID l_l3   = m_lineID + 10;
+  ID l_l4   = m_lineID + 11;
+
+  //! Line loop IDs
+  ID l_cll1 = m_lineLoopID;
+  ID l_cll2 = m_lineLoopID + 1;
+  ID l_cll3 = m_lineLoopID + 2;
+  ID l_cll4 = m_lineLoopID + 3;
+  ID l_cll5 = m_lineLoopID + 4;
+  ID l_cll6 = m_lineLoopID + 5;
+
+  //! Populate surface map and material volume list
+  std::vector< ID > l_vec{ l_cll1, l_cll2, l_cll3, l_cll4, l_cll5, l_cll6 };
+  i_mat->m_volList.push_back( m_surfaceLoopID );
+  m_surfMap[m_surfaceLoopID++] = l_vec;
+
+  //! Store radius and control points (writeManifest writes them to the mat file)
+  writeControlPoints( i_mat, i_rad, { i_cP[0], i_cP[5] } );
 
   //! Points
-  writePoint( l_cP1,  i_mat->m_meshSize );
-  writePoint( l_cP2,  i_mat->m_meshSize );
-  writePoint( l_cP3,  i_mat->m_meshSize );
-  writePoint( l_cP4,  i_mat->m_meshSize );
-  writePoint( l_cP5,  i_mat->m_meshSize );
-  writePoint( l_cP6,  i_mat->m_meshSize );
-  writePoint( l_cP7,  i_mat->m_meshSize );
-  writePoint( l_cP8,  i_mat->m_meshSize );
-  writePoint( l_cP9,  i_mat->m_meshSize );
-  writePoint( l_cP10, i_mat->m_meshSize );
+  for( int l_i = 0; l_i < 10; l_i++ )
+    writePoint( i_cP[l_i], i_mat->m_meshSize );
 
   m_out << std::endl;
 
@@ -604,9 +643,59 @@ void geo::Writer::writeCylinder( const geo::Material *i_mat ) {
 }
 
 //! ----------------------------------------------------------------------------
-//! Write spherical particle to geo script
+//! Insert spherical particle at random
+//! ----------------------------------------------------------------------------
+bool geo::Writer::insertSphere( geo::Material *i_mat ) {
+  real l_cX, l_cY, l_cZ,l_rad = 300.0;
+  geo::Sphere l_sph;
+  ID l_count = 0;
+
+  real l_meanRad = (i_mat->m_radMean ? i_mat->m_radMean :
+                                    ((i_mat->m_radMin + i_mat->m_radMax) / 2.0));
+  std::normal_distribution< real > l_distrib( l_meanRad, i_mat->m_radStdDev );
+
+  //! Repeat till sphere doesn't collide with any other particle
+  do {
+    //! Randomize radius
+    switch( i_mat->m_radDistrib ) {
+      case geo::Distrib::GAUSSIAN:
+        l_rad = l_distrib( m_rng );
+        break;
+      case geo::Distrib::UNIFORM:
+        l_rad = randomizer( i_mat->m_radMin, i_mat->m_radMax );
+        break;
+    }
+
+    //! Randomize center
+    l_cX = randomizer( m_tolPartBound + l_rad,
+                               m_length - l_rad - m_tolPartBound );
+    l_cY = randomizer( m_tolPartBound + l_rad,
+                               m_width  - l_rad - m_tolPartBound );
+    l_cZ = randomizer( m_tolPartBound + l_rad,
+                               m_height - l_rad - m_tolPartBound - m_pistonThicc );
+
+    l_sph = geo::Sphere( geo::Vector( l_cX, l_cY, l_cZ ), l_rad );
+
+    //! Infinite loop breaker
+    if( l_count++ > ITERLIM )
+      return setError( geo::Status::ERR_INSERTION,
+                       "Reached limit for iterative sphere insertion" );
+  } while( collisionDetection( l_sph ) );
+
+  //! Store newly inserted sphere info (for collision detection)
+  m_sphList.push_back( l_sph );
+
+  writeSphere( i_mat, l_sph.m_center, l_rad );
+
+  return true;
+}
+
+//! ----------------------------------------------------------------------------
+//! Write spherical particle (given by its center and radius) to geo script
 //! ----------------------------------------------------------------------------
-void geo::Writer::writeSphere( const geo::Material *i_mat ) {
+void geo::Writer::writeSphere(       geo::Material *i_mat,
+                               const geo::Vector   &i_center,
+                               const real          &i_rad ) {
   m_out << "//! Sphere\n";
 
   //! Sphere control points
@@ -642,67 +731,25 @@ void geo::Writer::writeSphere( const geo::Material *i_mat ) {
   ID l_sll7 = m_lineLoopID + 6;
   ID l_sll8 = m_lineLoopID + 7;
 
-  //! Populate surface map
+  //! Populate surface map and material volume list
   std::vector< ID > l_vec{ l_sll1, l_sll2, l_sll3, l_sll4,
                            l_sll5, l_sll6, l_sll7, l_sll8 };
+  i_mat->m_volList.push_back( m_surfaceLoopID );
   m_surfMap[m_surfaceLoopID++] = l_vec;
 
-  real l_cX, l_cY, l_cZ,l_rad = 300.0;
-  geo::Sphere l_sph;
-  ID l_count = 0;
-
-  //! Seed the Gaussian random generator
-  std::default_random_engine l_generator( m_seed );
+  real l_cX = i_center.m_x, l_cY = i_center.m_y, l_cZ = i_center.m_z;
 
-  real l_meanRad = (i_mat->m_radMean ? i_mat->m_radMean :
-                                    ((i_mat->m_radMin + i_mat->m_radMax) / 2.0));
-  std::normal_distribution< real > l_distrib( l_meanRad, i_mat->m_radStdDev );
-
-  //! Repeat till sphere doesn't collide with any other particle
-  do {
-    //! Randomize radius
-    switch( i_mat->m_radDistrib ) {
-      case geo::Distrib::GAUSSIAN:
-        l_rad = l_distrib( l_generator );
-        break;
-      case geo::Distrib::UNIFORM:
-        l_rad = randomizer< real >( i_mat->m_radMin, i_mat->m_radMax );
-        break;
-    }
-
-    //! Randomize center
-    l_cX = randomizer< real >( m_tolPartBound + l_rad,
-                               m_length - l_rad - m_tolPartBound );
-    l_cY = randomizer< real >( m_tolPartBound + l_rad,
-                               m_width  - l_rad - m_tolPartBound );
-    l_cZ = randomizer< real >( m_tolPartBound + l_rad,
-                               m_height - l_rad - m_tolPartBound - m_pistonThicc );
-
-    l_sph = geo::Sphere( geo::Vector( l_cX, l_cY, l_cZ ), l_rad );
-
-    //! Infinite loop breaker
-    if( l_count++ > ITERLIM ) {
-      std::cerr << "Reached limit for iterative sphere insertion! Exiting..\n";
-      m_out.close();
-      m_mat.close();
-      exit( EXIT_FAILURE );
-    }
-  } while( collisionDetection( l_sph ) );
-
-  //! Store newly inserted sphere info (for collision detection)
-  m_sphList.push_back( l_sph );
-
-  //! Write out control points to mat file
-  writeControlPoints( l_rad, { geo::Vector( l_cX, l_cY, l_cZ ) } );
+  //! Store radius and control points (writeManifest writes them to the mat file)
+  writeControlPoints( i_mat, i_rad, { i_center } );
 
   //! Points
   writePoint( geo::Vector( l_cX, l_cY, l_cZ ),         i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX - l_rad, l_cY, l_cZ ), i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX + l_rad, l_cY, l_cZ ), i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX, l_cY - l_rad, l_cZ ), i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX, l_cY + l_rad, l_cZ ), i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX, l_cY, l_cZ - l_rad ), i_mat->m_meshSize );
-  writePoint( geo::Vector( l_cX, l_cY, l_cZ + l_rad ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX - i_rad, l_cY, l_cZ ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX + i_rad, l_cY, l_cZ ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX, l_cY - i_rad, l_cZ ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX, l_cY + i_rad, l_cZ ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX, l_cY, l_cZ - i_rad ), i_mat->m_meshSize );
+  writePoint( geo::Vector( l_cX, l_cY, l_cZ + i_rad ), i_mat->m_meshSize );
 
   m_out << std::endl;
 
@@ -750,36 +797,27 @@ void geo::Writer::writeSphere( const geo::Material *i_mat ) {
 //! ----------------------------------------------------------------------------
 //! Write materials
 //! ----------------------------------------------------------------------------
-void geo::Writer::writeMaterials() {
+bool geo::Writer::writeMaterials() {
   //! Total matrix volume
   real l_totVol = m_length * m_width * (m_height - m_pistonThicc);
 
   //! Write material info
-  std::vector< geo::Material * >::const_iterator l_it;
+  std::vector< geo::Material >::iterator l_it;
   for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it ) {
     //! Material pointer
-    geo::Material *l_mat = *l_it;
-    m_mat << l_mat->m_name << std::endl;
+    geo::Material *l_mat = &(*l_it);
 
     //! Assign material mesh size to global mesh size if not specified by user
     if( !l_mat->m_meshSize )
       l_mat->m_meshSize = m_meshSize;
 
-    if( !l_mat->m_volFrac && !l_mat->m_count ) {
-      std::cerr << "Did not specify volume fraction or count for "
-                << l_mat->m_name << "! Exiting..\n";
-      m_out.close();
-      m_mat.close();
-      exit( EXIT_FAILURE );
-    }
+    if( !l_mat->m_volFrac && !l_mat->m_count )
+      return setError( geo::Status::ERR_CONFIG,
+                       "Did not specify volume fraction or count for " + l_mat->m_name );
 
-    if( l_mat->m_volFrac && l_mat->m_count ) {
-      std::cerr << "Cannot specify both volume fraction and count for "
-                << l_mat->m_name << "! Exiting..\n";
-      m_out.close();
-      m_mat.close();
-      exit( EXIT_FAILURE );
-    }
+    if( l_mat->m_volFrac && l_mat->m_count )
+      return setError( geo::Status::ERR_CONFIG,
+                       "Cannot specify both volume fraction and count for " + l_mat->m_name );
 
     switch( l_mat->m_morph ) {
       case geo::Morph::CYLINDER: {
@@ -796,22 +834,14 @@ void geo::Writer::writeMaterials() {
           l_cylCount = l_mat->m_count;
 
         //! For Gaussian distribution, we need both mean and standard deviation
-        if( l_mat->m_radMean && !l_mat->m_radStdDev ) {
-          std::cerr << "Did not specify standard deviation (radius) for "
-                    << l_mat->m_name << "! Exiting..\n";
-          m_out.close();
-          m_mat.close();
-          exit( EXIT_FAILURE);
-        }
+        if( l_mat->m_radMean && !l_mat->m_radStdDev )
+          return setError( geo::Status::ERR_CONFIG,
+                           "Did not specify standard deviation (radius) for " + l_mat->m_name );
 
         //! For Gaussian distribution, we need both mean and standard deviation
-        if( l_mat->m_lenMean && !l_mat->m_lenStdDev ) {
-          std::cerr << "Did not specify standard deviation (length) for "
-                    << l_mat->m_name << "! Exiting..\n";
-          m_out.close();
-          m_mat.close();
-          exit( EXIT_FAILURE);
-        }
+        if( l_mat->m_lenMean && !l_mat->m_lenStdDev )
+          return setError( geo::Status::ERR_CONFIG,
+                           "Did not specify standard deviation (length) for " + l_mat->m_name );
 
         //! Assign rad std dev if not specified by user (needs min and max tho)
         if( !l_mat->m_radStdDev && l_mat->m_radMin && l_mat->m_radMax )
@@ -821,12 +851,12 @@ void geo::Writer::writeMaterials() {
         if( !l_mat->m_lenStdDev && l_mat->m_lenMin && l_mat->m_lenMax )
           l_mat->m_lenStdDev = (l_mat->m_lenMax - l_mat->m_lenMin) / 6.0;
 
-        std::cout << l_mat->m_name << ": " << l_cylCount << " cyl" << std::endl;
-        //! Write no. of cylinders to mat file
-        m_mat << "cyl\n" << l_cylCount << std::endl;
+        if( m_log )
+          *m_log << l_mat->m_name << ": " << l_cylCount << " cyl" << std::endl;
 
         for( ID l_i = 0; l_i < l_cylCount; l_i++ )
-          writeCylinder( l_mat );
+          if( !insertCylinder( l_mat ) )
+            return false;
 
         break;
       }
@@ -843,33 +873,31 @@ void geo::Writer::writeMaterials() {
           l_sphCount = l_mat->m_count;
 
         //! For Gaussian distribution, we need both mean and standard deviation
-        if( l_mat->m_radMean && !l_mat->m_radStdDev ) {
-          std::cerr << "Did not specify standard deviation (radius) for "
-                    << l_mat->m_name << "! Exiting..\n";
-          m_out.close();
-          m_mat.close();
-          exit( EXIT_FAILURE);
-        }
+        if( l_mat->m_radMean && !l_mat->m_radStdDev )
+          return setError( geo::Status::ERR_CONFIG,
+                           "Did not specify standard deviation (radius) for " + l_mat->m_name );
 
         //! Assign rad std dev if not specified by user (needs min and max tho)
         if( !l_mat->m_radStdDev && l_mat->m_radMin && l_mat->m_radMax )
           l_mat->m_radStdDev = (l_mat->m_radMax - l_mat->m_radMin) / 6.0;
 
-        std::cout << l_mat->m_name << ": " << l_sphCount << " sph" << std::endl;
-        //! Write no. of spheres to mat file
-        m_mat << "sph\n" << l_sphCount << std::endl;
+        if( m_log )
+          *m_log << l_mat->m_name << ": " << l_sphCount << " sph" << std::endl;
 
         for( ID l_i = 0; l_i < l_sphCount; l_i++ )
-          writeSphere( l_mat );
+          if( !insertSphere( l_mat ) )
+            return false;
 
         break;
       }
     }
   }
+
+  return true;
 }
 
 //! ----------------------------------------------------------------------------
-//! Write footer information (surface loops and volumes) to geo script
+//! Write footer information (surface loops, volumes and physical groups)
 //! ----------------------------------------------------------------------------
 void geo::Writer::writeFooter() {
   m_out << "//! ------------------------------------------------------------\n";
@@ -881,227 +909,100 @@ void geo::Writer::writeFooter() {
 
   //! Write volumes info
   writeVolumes();
-}
 
-//! ----------------------------------------------------------------------------
-//! Checks if value in config entry is empty
-//! ----------------------------------------------------------------------------
-void geo::Writer::chkEmpty( const std::string &i_name,
-                            const std::string &i_val,
-                            const std::string &i_mat ) {
-  if( i_val.empty() ) {
-    std::cerr << "No value found for " << i_name
-              << (!i_mat.empty() ? " in " : "")
-              << (!i_mat.empty() ? i_mat : "" ) << "! Exiting..\n";
-    m_out.close();
-    m_mat.close();
-    exit( EXIT_FAILURE );
-  }
+  m_out << std::endl;
+
+  //! Write physical surfaces info
+  writePhysicalSurfaces();
+
+  //! Write physical volumes info
+  writePhysicalVolumes();
 }
 
 //! ----------------------------------------------------------------------------
-//! Config file parser
+//! Write binary material manifest (see GeoManifest.h for layout)
 //! ----------------------------------------------------------------------------
-void geo::Writer::parseConfigFile( const char *i_filename ) {
-  std::ifstream l_confFn( i_filename, std::ios::in );
-  if( !l_confFn.is_open() ) {
-    std::cerr << "Cannot open " << i_filename << "! Exiting..\n";
-    m_out.close();
-    m_mat.close();
-    exit( EXIT_FAILURE );
-  }
-
-  std::string l_lineBuf;
-  geo::Material *l_mat;
+bool geo::Writer::writeManifest() {
+  geo::ManifestHeader l_header;
+  std::vector< geo::ManifestMaterial > l_table( m_matList.size() );
 
-  while( getline( l_confFn, l_lineBuf ) ) {
-    size_t l_k = -1, l_l;
+  //! Particle arrays start right after the material table
+  uint64_t l_offset = sizeof( geo::ManifestHeader ) +
+                      l_table.size() * sizeof( geo::ManifestMaterial );
 
-    while( (++l_k < l_lineBuf.length()) && (l_lineBuf[l_k] == ' ') );
-
-    if( (l_k >= l_lineBuf.length()) || (l_lineBuf[l_k] == '#') )
-      continue;
+  for( size_t l_i = 0; l_i < m_matList.size(); l_i++ ) {
+    const geo::Material *l_mat = &m_matList[l_i];
+    geo::ManifestMaterial &l_entry = l_table[l_i];
 
-    l_l = l_k - 1;
-
-    while( (++l_l < l_lineBuf.length()) && (l_lineBuf[l_l] != '=') );
-
-    if( l_l >= l_lineBuf.length() )
-      continue;
+    if( l_mat->m_name.size() >= geo::MANIFEST_NAMELEN )
+      return setError( geo::Status::ERR_MANIFEST,
+                       "Material name too long (" + l_mat->m_name + ")" );
 
-    std::string l_varName  = l_lineBuf.substr( l_k, l_l - l_k );
-    std::string l_varValue = l_lineBuf.substr( l_l + 1 );
+    std::fill( l_entry.m_name, l_entry.m_name + geo::MANIFEST_NAMELEN, '\0' );
+    l_mat->m_name.copy( l_entry.m_name, l_mat->m_name.size() );
 
-    //! Skip specific entries without values
-    if( l_varValue.empty() &&
-         (l_varName == "length" || l_varName == "width" || l_varName == "height"
-       || l_varName == "tol_particles_boundaries" || l_varName == "count"
-       || l_varName == "tol_particles" || l_varName == "piston_thicc"
-       || l_varName == "global_mesh_size" || l_varName == "mesh_size"
-       || l_varName == "rand_seed" || l_varName == "vol_frac" ) )
-      continue;
-
-    //! Box
-    if( l_varName == "length" )
-      m_length          = StrToReal( l_varValue );
-    else if( l_varName == "width" )
-      m_width           = StrToReal( l_varValue );
-    else if( l_varName == "height" )
-      m_height          = StrToReal( l_varValue );
-    else if( l_varName == "global_mesh_size" )
-      m_meshSize        = StrToReal( l_varValue );
-
-    //! Tolerance values
-    else if( l_varName == "tol_particles" )
-      m_tolParticles    = StrToReal( l_varValue );
-    else if( l_varName == "tol_particles_boundaries" )
-      m_tolPartBound    = StrToReal( l_varValue );
-
-    //! Random seed
-    else if( l_varName == "rand_seed" )
-      m_seed            = StrToID( l_varValue );
-
-    //! Piston thickness
-    else if( l_varName == "piston_thicc" )
-      m_pistonThicc     = StrToID( l_varValue );
-
-    //! Material
-    else if( l_varName == "material" ) {
-      chkEmpty( l_varName, l_varValue );
-      l_mat = new geo::Material();
-      m_matList.push_back( l_mat );
-      l_mat->m_name     = l_varValue;
-    }
-    else if( l_varName == "vol_frac" )
-      l_mat->m_volFrac  = StrToReal( l_varValue );
-    else if( l_varName == "count" )
-      l_mat->m_count    = StrToID( l_varValue );
-    else if( l_varName == "mesh_size" )
-      l_mat->m_meshSize = StrToReal( l_varValue );
-    else if( l_varName == "morph" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      if( (l_varValue == "cylinder") || (l_varValue == "cyl") )
-        l_mat->m_morph  = geo::Morph::CYLINDER;
-      else if( (l_varValue == "sphere") || (l_varValue == "sph") )
-        l_mat->m_morph  = geo::Morph::SPHERE;
-      else {
-        std::cerr << "Unknown morphology (" << l_varValue << ")! Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE);
-      }
-    }
-
-    else if( l_varName == "rad_distrib" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      if( l_varValue == "gaussian" || l_varValue == "gauss" )
-        l_mat->m_radDistrib = geo::Distrib::GAUSSIAN;
-      else if( l_varValue == "uniform" || l_varValue == "flat" )
-        l_mat->m_radDistrib = geo::Distrib::UNIFORM;
-      else {
-        std::cerr << "Unknown distribution (" << l_varValue << ")! Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE);
-      }
-    }
-    else if( l_varName == "rad_mean" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      if( l_mat->m_radDistrib == geo::Distrib::GAUSSIAN )
-        l_mat->m_radMean  = StrToReal( l_varValue );
-      else {
-        std::cerr << "Cannot use rad_mean with Uniform distribution!\n"
-                  << "Please specify rad_min & rad_max OR use Gaussian distribution. Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE );
-      }
-    }
-    else if( l_varName == "rad_min" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_radMin     = StrToReal( l_varValue );
-    }
-    else if( l_varName == "rad_max" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_radMax     = StrToReal( l_varValue );
-    }
-    else if( l_varName == "rad_std_dev" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_radStdDev  = StrToReal( l_varValue );
-    }
-
-    else if( l_varName == "len_distrib" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      if( l_mat->m_morph == geo::Morph::SPHERE ) {
-        std::cerr << "Cannot use len specs with sphere morphology! Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE );
-      }
+    l_entry.m_morph        = (l_mat->m_morph == geo::Morph::CYLINDER) ? 0 : 1;
+    l_entry.m_cpStride     = (l_mat->m_morph == geo::Morph::CYLINDER) ? 6 : 3;
+    l_entry.m_numParticles = l_mat->m_radList.size();
+    l_entry.m_radOffset    = l_offset;
+    l_offset              += l_mat->m_radList.size() * sizeof( real );
+    l_entry.m_cpOffset     = l_offset;
+    l_offset              += l_mat->m_cpList.size() * sizeof( real );
+  }
 
-      if( l_varValue == "gaussian" || l_varValue == "gauss" )
-        l_mat->m_lenDistrib  = geo::Distrib::GAUSSIAN;
-      else if( l_varValue == "uniform" || l_varValue == "flat" )
-        l_mat->m_lenDistrib  = geo::Distrib::UNIFORM;
-      else {
-        std::cerr << "Unknown distribution (" << l_varValue << ")! Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE);
-      }
-    }
-    else if( l_varName == "len_mean" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      if( l_mat->m_morph == geo::Morph::SPHERE ) {
-        std::cerr << "Cannot use len specs with sphere morphology! Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE );
-      }
+  std::copy( geo::MANIFEST_MAGIC, geo::MANIFEST_MAGIC + 8, l_header.m_magic );
+  l_header.m_version      = geo::MANIFEST_VERSION;
+  l_header.m_endian       = geo::MANIFEST_ENDIAN;
+  l_header.m_numMaterials = l_table.size();
+  l_header.m_fileSize     = l_offset;
 
-      if( l_mat->m_lenDistrib == geo::Distrib::GAUSSIAN )
-        l_mat->m_lenMean = StrToReal( l_varValue );
-      else {
-        std::cerr << "Cannot use len_mean with Uniform distribution!\n"
-                  << "Please specify len_min & len_max OR use Gaussian distribution. Exiting..\n";
-        m_out.close();
-        m_mat.close();
-        exit( EXIT_FAILURE );
-      }
-    }
-    else if( l_varName == "len_min" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_lenMin     = StrToReal( l_varValue );
-    }
-    else if( l_varName == "len_max" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_lenMax     = StrToReal( l_varValue );
-    }
-    else if( l_varName == "len_std_dev" ) {
-      chkEmpty( l_varName, l_varValue, l_mat->m_name );
-      l_mat->m_lenStdDev  = StrToReal( l_varValue );
-    }
+  m_mat.write( reinterpret_cast< const char * >(&l_header), sizeof( l_header ) );
+  m_mat.write( reinterpret_cast< const char * >(l_table.data()),
+               l_table.size() * sizeof( geo::ManifestMaterial ) );
 
-    else
-      std::cerr << "Unknown setting (" << l_varName << "). Ignored.\n";
+  std::vector< geo::Material >::const_iterator l_it;
+  for( l_it = m_matList.begin(); l_it != m_matList.end(); ++l_it ) {
+    m_mat.write( reinterpret_cast< const char * >(l_it->m_radList.data()),
+                 l_it->m_radList.size() * sizeof( real ) );
+    m_mat.write( reinterpret_cast< const char * >(l_it->m_cpList.data()),
+                 l_it->m_cpList.size() * sizeof( real ) );
   }
 
-  l_confFn.close();
+  return true;
 }
 
 //! ----------------------------------------------------------------------------
 //! Write to geo file
 //! ----------------------------------------------------------------------------
-void geo::Writer::writeGeo() {
+geo::Status geo::Writer::writeGeo() {
+  //! Writer is single-use (and stays failed after an import error)
+  if( m_status != geo::Status::SUCCESS )
+    return m_status;
+
   //! Write header
   writeHeader();
 
   //! Write brake pad bounding box info along with piston
   writeBoxAndPiston();
 
-  //! Write materials
-  writeMaterials();
+  //! Write materials (imported or inserted at random)
+  if( m_import )
+    writeImportedMaterials();
+  else if( !writeMaterials() )
+    return m_status;
 
   //! Write footer
   writeFooter();
+
+  //! Write material manifest
+  if( !writeManifest() )
+    return m_status;
+
+  //! Sinks report failed writes (e.g. disk full)
+  m_out.flush();
+  m_mat.flush();
+  if( !m_out || !m_mat )
+    setError( geo::Status::ERR_IO, "Failed writing geo script or material manifest" );
+
+  return m_status;
 }
\ No newline at end of file
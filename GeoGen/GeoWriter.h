@@ -31,49 +31,27 @@
 #ifndef GEO_WRITER_H
 #define GEO_WRITER_H
 
-#include <fstream>
+#include <ostream>
 #include <map>
+#include <random>
 #include <vector>
 #include <tuple>
 #include <initializer_list>
 
 #include "Geo.hpp"
+#include "GeoConfig.h"
+#include "GeoManifest.h"
+#include "GeoImport.h"
 
 namespace geo {
-  enum class Distrib {
-    GAUSSIAN,
-    UNIFORM
-  };
-
-  struct Material;
-
   class Writer;
 }
 
-//! ----------------------------------------------------------------------------
-//! Material-block data-structure
-//! ----------------------------------------------------------------------------
-struct geo::Material {
-  real        m_meshSize, m_radMean, m_lenMean, m_radStdDev, m_lenStdDev;
-  real        m_volFrac, m_radMin, m_radMax, m_lenMin, m_lenMax;
-  ID          m_count;
-  std::string m_name;
-  Morph       m_morph;
-  Distrib     m_radDistrib, m_lenDistrib;
-
-  Material() : m_meshSize(0.0), m_radMean(0.0), m_lenMean(0.0),
-               m_radStdDev(0.0), m_lenStdDev(0.0), m_volFrac(0.0),
-               m_radMin(0.0), m_radMax(0.0), m_lenMin(0.0), m_lenMax(0.0),
-               m_count(0) {}
-};
-
 //! ----------------------------------------------------------------------------
 //! Writer class
 //! ----------------------------------------------------------------------------
 class geo::Writer {
 private:
-  clock_t m_time;
-
   //! ID variables
   ID m_pointID;
   ID m_lineID;
@@ -96,11 +74,16 @@ private:
   //! Piston thickness
   real m_pistonThicc;
 
-  //! Random seed
+  //! Random seed and generator (per instance)
   unsigned int m_seed;
+  std::mt19937 m_rng;
+
+  //! Output sinks (geo script, material manifest and optional log)
+  std::ostream &m_out, &m_mat, *m_log;
 
-  //! File output stream
-  std::ofstream m_out, m_mat;
+  //! Status and message of the first error
+  geo::Status m_status;
+  std::string m_error;
 
   //! Surface ID map
   std::map< ID, std::vector< ID > > m_surfMap;
@@ -110,7 +93,19 @@ private:
   std::vector< geo::Sphere >   m_sphList;
 
   //! Material list
-  std::vector< geo::Material * > m_matList;
+  std::vector< geo::Material > m_matList;
+
+  //! Imported particles (bulk import mode)
+  bool m_import;
+  std::vector< geo::Particle > m_importList;
+
+  //! Record error (returns false for convenience)
+  bool setError( const geo::Status &i_status,
+                 const std::string &i_error );
+
+  //! Uniformly distributed random number in [i_low, i_high)
+  real randomizer( const real &i_low,
+                   const real &i_high );
 
   //! Collision detection routines
   bool collisionDetection( const geo::Cylinder &i_cylinder ) const;
@@ -119,10 +114,12 @@ private:
   //! Check if out of bounds
   bool outOfBounds( const std::initializer_list< geo::Vector > &i_list ) const;
 
-  //! Check for empty fields in config file
-  void chkEmpty( const std::string &i_name,
-                 const std::string &i_val,
-                 const std::string &i_mat = "" );
+  //! Particle import routines
+  ID getMaterial( const std::string &i_name,
+                  const geo::Morph  &i_morph );
+  bool parseCsvParticles( const std::string &i_buf );
+  bool parseBinParticles( const std::string &i_buf );
+  bool validateParticles();
 
   //! Helper functions
   void writePoint( const geo::Vector   &i_point,
@@ -136,23 +133,50 @@ private:
                          const std::vector< ID > &i_list );
   void writeSurfaceLoops();
   void writeVolumes();
-  void writeControlPoints( const real                                 &i_rad,
+  void writePhysicalSurfaces();
+  void writePhysicalVolumes();
+  void writeControlPoints(       geo::Material                        *i_mat,
+                           const real                                 &i_rad,
                            const std::initializer_list< geo::Vector > &i_list );
 
   //! Writer functions
   void writeHeader();
   void writeBoxAndPiston();
-  void writeCylinder( const geo::Material *i_mat );
-  void writeSphere( const geo::Material *i_mat );
-  void writeMaterials();
+  static void getCylinderPoints( const geo::Vector &i_base,
+                                 const geo::Matrix &i_rmat,
+                                 const real        &i_rad,
+                                 const real        &i_len,
+                                 geo::Vector      (&o_cP)[10] );
+  bool insertCylinder( geo::Material *i_mat );
+  bool insertSphere( geo::Material *i_mat );
+  void writeCylinder(       geo::Material *i_mat,
+                      const geo::Vector  (&i_cP)[10],
+                      const real          &i_rad );
+  void writeSphere(       geo::Material *i_mat,
+                    const geo::Vector   &i_center,
+                    const real          &i_rad );
+  bool writeMaterials();
+  void writeImportedMaterials();
   void writeFooter();
+  bool writeManifest();
 
 public:
-  Writer( const char* i_filename );
-  ~Writer();
-
-  void parseConfigFile( const char *i_filename );
-  void writeGeo();
+  Writer( const geo::Config &i_config,
+          std::ostream      &o_geo,
+          std::ostream      &o_mat,
+          std::ostream      *o_log = nullptr );
+
+  //! Import particles instead of inserting them at random
+  geo::Status importParticles( const char        *i_filename );
+  geo::Status importParticles( const std::string &i_buf );
+
+  //! Write geo script and material manifest to the sinks
+  geo::Status writeGeo();
+
+  //! Results
+  const std::string                  &getError()     const { return m_error; }
+  unsigned int                        getSeed()      const { return m_seed; }
+  const std::vector< geo::Material > &getMaterials() const { return m_matList; }
 };
 
 #endif
\ No newline at end of file
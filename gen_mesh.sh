@@ -97,12 +97,13 @@ mkdir -p $MSHDIR
 printf -v GEO '%s%s.geo' "$MSHDIR" "$MODEL"
 printf -v MSH '%s%s.msh' "$MSHDIR" "$MODEL"
 printf -v DAT '%s%s.dat' "$MSHDIR" "$MODEL"
+printf -v MATFILE '%s%s.mat' "$MSHDIR" "$MODEL"
 
 # Generate geo using GeoGen program
 printf "\n-----------------------------"
 printf "\nGeoGen: Generating geo file.."
 printf "\n-----------------------------\n"
-./GeoGen/GeoGen -f $CONF -o $GEO
+./GeoGen/GeoGen -f $CONF -o $GEO -m $MATFILE
 
 # Exit if GeoGen failed
 if [ $? -ne 0 ]
@@ -129,7 +130,7 @@ fi
 printf "\n--------------------------------"
 printf "\nEurekaGen: Generating dat file.."
 printf "\n--------------------------------\n"
-./EurekaGen/EurekaGen -f $CONF -i $MSH -o $DAT
+./EurekaGen/EurekaGen -f $CONF -i $MSH -o $DAT -m $MATFILE
 
 # Exit if EurekaGen failed
 if [ $? -ne 0 ]
@@ -140,5 +141,5 @@ fi
 # Remove intermediate material file
 if [ $MAT -eq 1 ]
 then
-  rm -f GeoGen.mat
+  rm -f $MATFILE
 fi
\ No newline at end of file